@@ -17,177 +17,158 @@
  |                                                                          |
 \*--------------------------------------------------------------------------*/
 
-#include "PolynomialRoots.hh"
-#include <cmath>
-#include <iostream>
-#include <algorithm>
-#include <limits>
+// the batch kernels compiled for each SIMD level must round as the generic
+// code, so clang must not contract a*b+c also in the inlined header code
+#ifdef __clang__
+#pragma STDC FP_CONTRACT OFF
+#endif
 
-namespace PolynomialRoots {
-
-  using std::abs;
-  static valueType const machepsi = std::numeric_limits<valueType>::epsilon();
-
-  indexType
-  Quadratic::getRealRoots( valueType r[] ) const {
-    indexType nr = 0;
-    if ( !cplx ) {
-      r[nr++] = r0;
-      if ( nrts > 1 ) r[nr++] = r1;
-    }
-    return nr;
-  }
+#include "PolynomialRoots-inline.hh"
 
-  indexType
-  Quadratic::getPositiveRoots( valueType r[] ) const {
-    indexType nr = 0;
-    if ( !cplx ) {
-      if ( r0 > 0 ) r[nr++] = r0;
-      if ( nrts > 1 && r1 > 0 ) r[nr++] = r1;
-    }
-    return nr;
-  }
+namespace PolynomialRoots {
 
-  indexType
-  Quadratic::getNegativeRoots( valueType r[] ) const {
-    indexType nr = 0;
-    if ( !cplx ) {
-      if ( r0 < 0 ) r[nr++] = r0;
-      if ( nrts > 1 && r1 < 0 ) r[nr++] = r1;
-    }
-    return nr;
-  }
+  /*
+  ||   _           _       _
+  ||  | |__   __ _| |_ ___| |__
+  ||  | '_ \ / _` | __/ __| '_ \
+  ||  | |_) | (_| | || (__| | | |
+  ||  |_.__/ \__,_|\__\___|_| |_|
+  */
 
-  void
-  Quadratic::eval( valueType x, valueType & p, valueType & dp ) const {
-    valueType const & A = ABC[0];
-    valueType const & B = ABC[1];
-    valueType const & C = ABC[2];
-    if ( std::abs(x) > 1 ) {
-      valueType z  = 1/x;
-      valueType x2 = x*x;
-      p = ((C*z+B)*z+A)*x2;
-    } else {
-      p = (A*x+B)*x+C;
-    }
-    dp = 2*A*x+B;
-  }
+  // number of quadratics solved together, the flags are stored after each block
+  static indexType const numLanes = 64;
 
   /*\
-   *  Calculate the zeros of the quadratic a*z^2 + b*z + c.
-   *  The quadratic formula, modified to avoid overflow, is used
-   *  to find the larger zero if the zeros are real and both
-   *  are complex. The smaller real zero is found directly from
-   *  the product of the zeros c/a.
+   *  The branches of QuadraticT::findRoots are all computed and blended with
+   *  selects. A division by zero in a branch that is not taken gives inf or
+   *  NaN that is discarded by the select (no floating point traps are
+   *  enabled by the library). isZero(x) is written x == 0, the same test.
+   *  The roots are the same computed by QuadraticT, bit by bit. GCC needs
+   *  -fno-math-errno (set in the build files) to vectorize the sqrt.
+   *  The kernel is compiled for each SimdLevel and selected by runKernel.
   \*/
 
+  template <typename Real>
+  struct QuadraticBatchKernel {
+    static POLYNOMIAL_ROOTS_KERNEL void run(
+      indexType n, Real const A[], Real const B[], Real const C[],
+      Real r0[], Real r1[], indexType nrts[], bool cplx[], bool dblx[]
+    );
+  };
+
+  template <typename Real>
+  POLYNOMIAL_ROOTS_KERNEL
   void
-  Quadratic::findRoots() {
-    valueType const & A = ABC[0];
-    valueType const & B = ABC[1];
-    valueType const & C = ABC[2];
-
-    r0 = r1 = 0;
-    nrts = 0;
-    cplx = dblx = false;
-
-    if ( isZero(A) ) { // less than two roots b*z + c = 0
-      if ( !isZero(B) ) { nrts = 1; r0 = -C/B; }
-    } else if ( isZero(C) ) { // a*z^2 + b*z  = 0
-      nrts = 2;
-      dblx = isZero(B);
-      if ( !dblx ) {
-        r0 = -B/A;
-        if ( r0 < 0 ) std::swap(r0,r1);
+  QuadraticBatchKernel<Real>::run(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real            r0[],
+    Real            r1[],
+    indexType       nrts[],
+    bool            cplx[],
+    bool            dblx[]
+  ) {
+    Real a[numLanes], b[numLanes], c[numLanes];
+    // roots of the linear and a*z^2 + b*z cases and of the full quadratic
+    Real q[numLanes], re[numLanes], im[numLanes], s0[numLanes], s1[numLanes];
+    Real e1[numLanes], e2[numLanes], sc[numLanes], e[numLanes], d[numLanes];
+    // 0/1 flags of the lanes, the bool outputs do not vectorize
+    indexType nr[numLanes], cp[numLanes], db[numLanes];
+    for ( indexType i0 = 0; i0 < n; i0 += numLanes ) {
+      // the last block is padded with x^2-1 so that all the loops have numLanes
+      // iterations, the loads from the local arrays are then known not to trap
+      indexType m = std::min( numLanes, n-i0 );
+      std::copy( A+i0, A+i0+m, a ); std::fill( a+m, a+numLanes, Real(1) );
+      std::copy( B+i0, B+i0+m, b ); std::fill( b+m, b+numLanes, Real(0) );
+      std::copy( C+i0, C+i0+m, c ); std::fill( c+m, c+numLanes, Real(-1) );
+
+      // The values of all the branches are computed and stored for all the
+      // lanes and the last loop selects them. A division or a product used
+      // only under a condition is moved by the compiler into a branch that
+      // cannot be vectorized, so the operations are split in three loops.
+      for ( indexType l = 0; l < numLanes; ++l ) {
+        // -c/b if b*z + c = 0, -b/a if a*z^2 + b*z = 0
+        bool linear = a[l] == 0;
+        q[l] = -( linear ? c[l] : b[l] )/( linear ? b[l] : a[l] );
+        // discriminant avoiding overflow
+        Real hb    = b[l]/2;
+        Real abs_b = abs(hb);
+        e1[l] = (hb*hb)-(c[l] < 0 ? -a[l] : a[l])*abs(c[l]);
+        e2[l] = 1 - (a[l]/hb)*(c[l]/hb);
+        sc[l] = abs_b < abs(c[l]) ? 1 : abs_b;
       }
-    } else { // Compute discriminant avoiding overflow.
-      valueType hb    = B/2; // b now b/2
-      valueType abs_b = abs(hb);
-      valueType abs_c = abs(C);
-      valueType e, d;
-      if ( abs_b < abs_c ) {
-        e = C < 0 ? -A : A;
-        e = (hb*hb)-e*abs_c;
-        d = std::sqrt(std::abs(e));
-      } else {
-        e = 1 - (A/hb)*(C/hb);
-        d = std::sqrt(std::abs(e))*abs_b;
+      for ( indexType l = 0; l < numLanes; ++l ) {
+        Real hb = b[l]/2;
+        e[l]  = abs(hb) < abs(c[l]) ? e1[l] : e2[l];
+        d[l]  = sqrt(abs(e[l])) * sc[l];
+        re[l] = -hb/a[l];
+        im[l] = abs(d[l]/a[l]);
+        s0[l] = ((hb >= 0 ? -d[l] : d[l])-hb)/a[l];
+        s1[l] = (c[l]/s0[l])/a[l];
+      }
+      for ( indexType l = 0; l < m; ++l ) {
+        bool linear = a[l] == 0;
+        bool noC    = !linear & (c[l] == 0);
+        bool full   = !linear & !noC;
+
+        // b*z + c = 0
+        bool lin1 = linear & (b[l] != 0);
+        Real rl0  = lin1 ? q[l] : 0;
+
+        // a*z^2 + b*z = 0, the roots 0 and -b/a with the order of findRoots
+        bool zdbl = b[l] == 0;
+        bool zneg = !zdbl & (q[l] < 0);
+        Real rz0  = zdbl | zneg ? 0 : q[l];
+        Real rz1  = zneg ? q[l] : 0;
+
+        // full quadratic
+        bool cpx = e[l] < 0;
+        bool dbl = !cpx & (d[l] == 0);
+        Real t1  = s0[l] != 0 ? s1[l] : 0;
+        Real lo  = s0[l] > t1 ? t1 : s0[l];
+        Real hi  = s0[l] > t1 ? s0[l] : t1;
+        Real rf0 = cpx | dbl ? re[l] : lo;
+        Real rf1 = cpx ? im[l] : ( dbl ? re[l] : hi );
+
+        r0[i0+l] = full ? rf0 : ( noC ? rz0 : rl0 );
+        r1[i0+l] = full ? rf1 : ( noC ? rz1 : 0 );
+        nr[l]    = linear ? ( lin1 ? 1 : 0 ) : 2;
+        cp[l]    = full & cpx ? 1 : 0;
+        db[l]    = (full & dbl) | (noC & zdbl) ? 1 : 0;
       }
-      nrts = 2;
-      cplx = e < 0;
-      if ( cplx ) {
-        // complex conjugate zeros
-        r0 = -hb/A;         // real part
-        r1 = std::abs(d/A); // immaginary part
-      } else {
-        // real zeros
-        dblx = isZero(d);
-        if ( dblx ) {
-          r0 = r1 = -hb/A;
-        } else {
-          if ( hb >= 0 ) d = -d;
-          r0 = (d-hb)/A;
-          //r1 = (-d-hb)/a;
-          if ( !isZero(r0) ) r1 = (C/r0)/A;
-          if ( r0 > r1 ) std::swap(r0,r1); // order roots
-        }
+      for ( indexType l = 0; l < m; ++l ) {
+        nrts[i0+l] = nr[l];
+        cplx[i0+l] = cp[l] != 0;
+        dblx[i0+l] = db[l] != 0;
       }
     }
   }
 
+  template <typename Real>
   void
-  Quadratic::info( std::ostream & s ) const {
-    valueType const & A = ABC[0];
-    valueType const & B = ABC[1];
-    valueType const & C = ABC[2];
-    s << "\npoly A=" << A << " B=" << B << " C=" << C
-      << "\nn. roots = " << nrts
-      << "\ncomplex  = " << (cplx?"YES":"NO")
-      << "\ndouble   = " << (dblx?"YES":"NO");
-    if ( cplx ) {
-      s << "\nx0 = (" << r0 << "," <<  r1 << ')'
-        << "\nx1 = (" << r0 << "," << -r1 << ')';
-    } else if ( dblx ) {
-      s << "\nx0 = x1 = " << r0;
-    } else if ( nrts == 1 ) {
-      s << "\nx0 = " << r0;
-    } else if ( nrts == 2 ) {
-      s << "\nx0 = " << r0
-        << "\nx1 = " << r1;
-    }
-    s << '\n';
+  solveQuadraticBatch(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real            r0[],
+    Real            r1[],
+    indexType       nrts[],
+    bool            cplx[],
+    bool            dblx[]
+  ) {
+    runKernel<QuadraticBatchKernel<Real> >( n, A, B, C, r0, r1, nrts, cplx, dblx );
   }
 
-  bool
-  Quadratic::check( std::ostream & s ) const {
-    valueType const & A = ABC[0];
-    valueType const & B = ABC[1];
-    valueType const & C = ABC[2];
-    bool ok = true;
-    valueType epsi = 10 * ( std::abs(A) +
-                            std::abs(B) +
-                            std::abs(C) ) * machepsi;
-    if ( cplx ) {
-      valueType z0 = std::abs(eval( root0() ));
-      valueType z1 = std::abs(eval( root1() ));
-      s << "|p(r0)| = " << z0
-        << "\n|p(r1)| = " << z1
-        << '\n';
-      ok = z0 < epsi && z1 < epsi;
-    } else if ( nrts == 1 ) {
-      valueType z0 = eval( real_root0() );
-      s << "p(r0) = " << z0  << '\n';
-      ok = std::abs(z0) < epsi;
-    } else if ( nrts == 2 ) {
-      valueType z0 = eval( real_root0() );
-      valueType z1 = eval( real_root1() );
-      s << "p(r0) = " << z0
-        << "\np(r1) = " << z1
-        << '\n';
-      ok = std::abs(z0) < epsi && std::abs(z1) < epsi;
-    }
-    return ok;
-  }
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                                 \
+  template class QuadraticT<Real>;                                           \
+  template void solveQuadraticBatch( indexType, Real const [], Real const [], \
+                                     Real const [], Real [], Real [],        \
+                                     indexType [], bool [], bool [] );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
 
 }
 
@@ -17,7 +17,13 @@
  |                                                                          |
 \*--------------------------------------------------------------------------*/
 
-#include "PolynomialRoots.hh"
+// the batch kernels compiled for each SIMD level must round as the generic
+// code, so clang must not contract a*b+c also in the inlined header code
+#ifdef __clang__
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include "PolynomialRoots-inline.hh"
 #include <cmath>
 #include <iostream>
 #include <algorithm>
@@ -25,11 +31,9 @@
 
 namespace PolynomialRoots {
 
-  using std::abs;
-  static valueType const machepsi = std::numeric_limits<valueType>::epsilon();
-
+  template <typename Real>
   indexType
-  Quartic::getRealRoots( valueType r[] ) const {
+  QuarticT<Real>::getRealRoots( valueType r[] ) const {
     indexType nr = 0;
     if ( !cplx0() ) r[nr++] = r0;
     if ( !cplx1() ) r[nr++] = r1;
@@ -38,8 +42,9 @@ namespace PolynomialRoots {
     return nr;
   }
 
+  template <typename Real>
   indexType
-  Quartic::getPositiveRoots( valueType r[] ) const {
+  QuarticT<Real>::getPositiveRoots( valueType r[] ) const {
     indexType nr = 0;
     if ( !cplx0() && r0 > 0 ) r[nr++] = r0;
     if ( !cplx1() && r1 > 0 ) r[nr++] = r1;
@@ -48,8 +53,9 @@ namespace PolynomialRoots {
     return nr;
   }
 
+  template <typename Real>
   indexType
-  Quartic::getNegativeRoots( valueType r[] ) const {
+  QuarticT<Real>::getNegativeRoots( valueType r[] ) const {
     indexType nr = 0;
     if ( !cplx0() && r0 < 0 ) r[nr++] = r0;
     if ( !cplx1() && r1 < 0 ) r[nr++] = r1;
@@ -58,127 +64,55 @@ namespace PolynomialRoots {
     return nr;
   }
 
-  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-  //
-  // x^4 + A x^3 + B x^2 + C x + D
-  static
-  inline
-  void
-  scaleQuarticMonicPolynomial(
-    valueType   A,
-    valueType   B,
-    valueType   C,
-    valueType   D,
-    valueType & AS,
-    valueType & BS,
-    valueType & CS,
-    valueType & DS,
-    indexType & i_case,
-    valueType & scale
-  ) {
-
-    valueType a = abs(A);
-    valueType b = sqrt(abs(B));
-    valueType c = cbrt(abs(C));
-    valueType d = sqrt(sqrt(abs(D)));
-
-    if ( a < b ) {
-      if ( b < c ) {
-        if ( c < d ) i_case = 0; // a < b < c < d        --> d MAX
-        else         i_case = 1; // a < b < c and d <= c --> c MAX
-      } else {
-        if ( b < d ) i_case = 0; // a < b and c <= b < d --> d MAX
-        else         i_case = 2; // a < b and c <= b and d <= b --> b MAX
-      }
-    } else {
-      if ( a < c ) {
-        if ( c < d ) i_case = 0; // b <= a < c < d        --> d MAX
-        else         i_case = 1; // b <= a < c and d <= c --> c MAX
-      } else {
-        if ( a < d ) i_case = 0; // b <= a and c <= a and a < d --> d MAX
-        else         i_case = 3; // b <= a and c <= a and d <= a --> a MAX
-      }
-    }
-
-    switch ( i_case ) {
-      case 0:
-        scale = d;
-        AS    = A/d;
-        BS    = (B/d)/d;
-        CS    = ((C/d)/d)/d;
-        DS    = D > 0 ? 1 : -1;
-      break;
-      case 1:
-        scale = c;
-        AS    = A/c;
-        BS    = (B/c)/c;
-        CS    = C > 0 ? 1 : -1;
-        DS    = (((D/c)/c)/c)/c;
-      break;
-      case 2:
-        scale = b;
-        AS    = A/b;
-        BS    = B > 0 ? 1 : -1;
-        CS    = ((C/b)/b)/b;
-        DS    = (((D/b)/b)/b)/b;
-      break;
-      case 3:
-        scale = a;
-        AS    = A > 0 ? 1 : -1;
-        BS    = (B/a)/a;
-        CS    = ((C/a)/a)/a;
-        DS    = (((D/a)/a)/a)/a;
-      break;
-    }
-  }
-
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  template <typename Real>
   static
   inline
-  valueType
+  Real
   evalHexic(
-    valueType x,
-    valueType q3,
-    valueType q2,
-    valueType q1,
-    valueType q0
+    Real      x,
+    Real      q3,
+    Real      q2,
+    Real      q1,
+    Real      q0
   ) {
-    valueType t1 = x + q3;
-    valueType t2 = x + t1;
-    valueType t3 = x + t2;
+    Real t1 = x + q3;
+    Real t2 = x + t1;
+    Real t3 = x + t2;
     t1 = t1 * x + q2;
     t2 = t2 * x + t1;
     t1 = t1 * x + q1;
-    valueType Q    = t1 * x + q0; // Q(x)
-    valueType dQ   = t2 * x + t1; // Q'(x)
-    valueType ddQ  = t3 * x + t2; // Q''(x) / 2
-    valueType dddQ = x + t3;      // Q'''(x) / 6
+    Real Q    = t1 * x + q0; // Q(x)
+    Real dQ   = t2 * x + t1; // Q'(x)
+    Real ddQ  = t3 * x + t2; // Q''(x) / 2
+    Real dddQ = x + t3;      // Q'''(x) / 6
     return  Q * dddQ * dddQ - dQ * ddQ * dddQ + dQ * dQ; // H(x), usually < 0
   }
 
+  template <typename Real>
   static
   inline
   void
   evalHexic(
-    valueType   x,
-    valueType   q3,
-    valueType   q2,
-    valueType   q1,
-    valueType   q0,
-    valueType & p,
-    valueType & dp
+    Real        x,
+    Real        q3,
+    Real        q2,
+    Real        q1,
+    Real        q0,
+    Real      & p,
+    Real      & dp
   ) {
-    valueType t1 = x + q3;
-    valueType t2 = x + t1;
-    valueType t3 = x + t2;
+    Real t1 = x + q3;
+    Real t2 = x + t1;
+    Real t3 = x + t2;
     t1 = t1 * x + q2;
     t2 = t2 * x + t1;
     t1 = t1 * x + q1;
-    valueType Q    = t1 * x + q0; // Q(x)
-    valueType dQ   = t2 * x + t1; // Q'(x)
-    valueType ddQ  = t3 * x + t2; // Q''(x) / 2
-    valueType dddQ = x + t3;      // Q'''(x) / 6
+    Real Q    = t1 * x + q0; // Q(x)
+    Real dQ   = t2 * x + t1; // Q'(x)
+    Real ddQ  = t3 * x + t2; // Q''(x) / 2
+    Real dddQ = x + t3;      // Q'''(x) / 6
     p  = Q * dddQ * dddQ - dQ * ddQ * dddQ + dQ * dQ; // H(x), usually < 0
     dp = 2 * dddQ * (4 * Q - dQ * dddQ - ddQ * ddQ); // H'(x)
   }
@@ -186,23 +120,24 @@ namespace PolynomialRoots {
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   //
   // a4*x^4 + a3*x^3 + a2*x^2 + a1*x + a0 = (x-r)*(a4*x^3+b2*x^2+b1*x+b0)
+  template <typename Real>
   static
   void
   deflateQuarticPolynomial(
-    valueType   a4,
-    valueType   a3,
-    valueType   a2,
-    valueType   a1,
-    valueType   a0,
-    valueType   r,
-    valueType & b2,
-    valueType & b1,
-    valueType & b0
+    Real        a4,
+    Real        a3,
+    Real        a2,
+    Real        a1,
+    Real        a0,
+    Real        r,
+    Real      & b2,
+    Real      & b1,
+    Real      & b0
   ) {
     indexType i_cross  = 0;
-    valueType r2       = r*r;
-    valueType v_cross  = abs(a0);
-    valueType v_cross1 = abs(a1*r);
+    Real      r2       = r*r;
+    Real      v_cross  = abs(a0);
+    Real      v_cross1 = abs(a1*r);
     if ( v_cross1 > v_cross ) { v_cross = v_cross1; i_cross = 1; }
     v_cross1 = abs(a2*r2);
     if ( v_cross1 > v_cross ) { v_cross = v_cross1; i_cross = 2; }
@@ -229,29 +164,32 @@ namespace PolynomialRoots {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // Translate to C from Polynomial234RootSolvers
+  template <typename Real>
   static
   indexType
   zeroQuarticByNewtonBisection(
-    valueType  a,
-    valueType  b,
-    valueType  c,
-    valueType  d,
-    valueType & x
+    Real       a,
+    Real       b,
+    Real       c,
+    Real       d,
+    Real      & x
   ) {
+    Real const machepsi = machineEpsilon<Real>();
 
-    valueType p, dp;
+    Real p, dp;
     evalMonicQuartic( x, a, b, c, d, p, dp );
-    valueType t = p; // save p(x) for sign comparison
+    if ( isZero(p) ) return 0; // x is a root, possibly multiple with dp = 0
+    Real t = p; // save p(x) for sign comparison
     x -= p/dp; // 1st improved root
 
     indexType iter      = 1;
     indexType oscillate = 0;
     bool      bisection = false;
     bool      converged = false;
-    valueType s(0), u(0); // to mute warning
-    while ( ! (converged||bisection) && iter < 50 ) {
+    Real      s(0), u(0); // to mute warning
+    while ( ! (converged||bisection) && iter < maxNewtonIter ) {
       ++iter;
-      valueType ddp;
+      Real ddp;
       evalMonicQuartic( x, a, b, c, d, p, dp, ddp );
       if ( p*t < 0 ) { // does Newton start oscillating ?
         if ( p < 0 ) {
@@ -263,16 +201,19 @@ namespace PolynomialRoots {
         t = p; // save current p(x)
       }
       //dp = (p*dp)/(dp*dp-p*ddp); // double zero correction
-      dp = (p*dp)/(dp*dp-0.5*p*ddp); // Halley correction
+      dp = (p*dp)/(dp*dp-p*ddp/2); // Halley correction
       //dp = p/dp; // Newton correction
       x -= dp; // new Newton root
       bisection = oscillate > 2; // activate bisection
-      converged = std::abs(dp) <= std::abs(x) * machepsi; // Newton convergence indicator
+      converged = abs(dp) <= abs(x) * machepsi; // Newton convergence indicator
     }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_NEWTON_ITER, iter );
     if ( bisection || !converged ) {
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_BISECTION, 1 );
       t = u - s; // initial bisection interval
       while ( abs(t) > abs(x) * machepsi ) { // bisection iterates
         ++iter;
+        POLYNOMIAL_ROOTS_COUNT( QUARTIC_BISECTION_ITER, 1 );
         p = evalMonicQuartic( x, a, b, c, d );
         if ( p < 0 ) s = x;
         else         u = x; // keep bracket on root
@@ -285,26 +226,28 @@ namespace PolynomialRoots {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // Translate to C from Polynomial234RootSolvers
+  template <typename Real>
   static
   indexType
   zeroHexicByNewtonBisection(
-    valueType   q3,
-    valueType   q2,
-    valueType   q1,
-    valueType   q0,
-    valueType & x
+    Real        q3,
+    Real        q2,
+    Real        q1,
+    Real        q0,
+    Real      & x
   ) {
-    valueType p, dp;
+    Real const machepsi = machineEpsilon<Real>();
+    Real p, dp;
     evalHexic( x, q3, q2, q1, q0, p, dp );
-    valueType t = p; // save p(x) for sign comparison
+    Real t = p; // save p(x) for sign comparison
     x -= p/dp; // 1st improved root
 
     indexType iter      = 1;
     indexType oscillate = 0;
     bool      bisection = false;
     bool      converged = false;
-    valueType s(0), u(0); // to mute warning
-    while ( ! (converged||bisection) ) {
+    Real      s(0), u(0); // to mute warning
+    while ( ! (converged||bisection) && iter < maxNewtonIter ) {
       ++iter;
       evalHexic( x, q3, q2, q1, q0, p, dp );
       if ( p*t < 0 ) { // does Newton start oscillating ?
@@ -321,10 +264,13 @@ namespace PolynomialRoots {
       bisection = oscillate > 2; // activate bisection
       converged = abs(dp) <= abs(x) * machepsi; // Newton convergence indicator
     }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_NEWTON_ITER, iter );
     if ( bisection ) {
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_BISECTION, 1 );
       t = u - s; // initial bisection interval
       while ( abs(t) > abs(x) * machepsi ) { // bisection iterates
         ++iter;
+        POLYNOMIAL_ROOTS_COUNT( QUARTIC_BISECTION_ITER, 1 );
         p = evalHexic( x, q3, q2, q1, q0 );
         if ( p < 0 ) s = x;
         else         u = x; // keep bracket on root
@@ -337,6 +283,132 @@ namespace PolynomialRoots {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  /*\
+   *  Real parts a, b and imaginary parts c, d of the roots a +/- I*c and
+   *  b +/- I*d of x^4 + A3*x^3 + A2*x^2 + A1*x + A0 with only complex
+   *  roots, given the real part a of a pair (a root of the hexic).
+  \*/
+
+  template <typename Real>
+  static
+  inline
+  void
+  quarticComplexParts(
+    Real        a,
+    Real        A3,
+    Real        A2,
+    Real        A1,
+    Real        A0,
+    Real      & b,
+    Real      & c,
+    Real      & d
+  ) {
+    b = -A3/2 - a; // 2nd real component -> b
+
+    Real x = 4 * a + A3; // Q'''(a)
+    Real y = x + 2*A3;
+    y = y * a + 2*A2; // Q'(a)
+    y = y * a + A1;
+    y /= x;
+    if ( y < 0 ) y = 0; // ensure Q'(a) / Q'''(a) >= 0
+
+    x = 4 * b + A3; // Q'''(b)
+    Real z = x + 2*A3;
+    z = z * b + 2*A2; // Q'(b)
+    z = z * b + A1;
+    z /= x;
+    if ( z < 0 ) z = 0; // ensure Q'(b) / Q'''(b) >= 0
+
+    c = a * a;              // store a^2 for later
+    d = b * b;              // store b^2 for later
+    Real ss = c + y;   // magnitude^2 of (a + iy) root
+    Real tt = d + z;   // magnitude^2 of (b + iz) root
+
+    if ( ss > tt ) {         // minimize imaginary error
+      c = sqrt(y);           // 1st imaginary component -> c
+      d = sqrt(A0 / ss - d); // 2nd imaginary component -> d
+    } else {
+      c = sqrt(A0 / tt - c); // 1st imaginary component -> c
+      d = sqrt(z);           // 2nd imaginary component -> d
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   *  Halley iterations on x^4 + a*x^3 + b*x^2 + c*x + d from the root x of
+   *  a near quartic, as in NewtonWarmStart.
+   *  Return false if they do not converge in a few steps.
+  \*/
+
+  template <typename Real>
+  static
+  bool
+  zeroQuarticWarmStart(
+    Real        a,
+    Real        b,
+    Real        c,
+    Real        d,
+    Real      & x,
+    indexType & iter
+  ) {
+    Real dx0 = 0;
+    bool converged = false;
+    for ( iter = 0; !converged && iter < 8; ) {
+      ++iter;
+      Real p, dp, ddp;
+      evalMonicQuartic( x, a, b, c, d, p, dp, ddp );
+      if ( isZero(p) ) { converged = true; break; }
+      Real dx = (p*dp)/(dp*dp-p*ddp/2); // Halley correction
+      x        -= dx;
+      converged = warmConverged( dx, dx0, x, 3 );
+      dx0       = dx;
+    }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_NEWTON_ITER, iter );
+    return converged;
+  }
+
+  // the same with Newton iterations on the hexic of the real parts
+  template <typename Real>
+  static
+  bool
+  zeroHexicWarmStart(
+    Real        q3,
+    Real        q2,
+    Real        q1,
+    Real        q0,
+    Real      & x,
+    indexType & iter
+  ) {
+    Real dx0 = 0;
+    bool converged = false;
+    for ( iter = 0; !converged && iter < 8; ) {
+      ++iter;
+      Real p, dp;
+      evalHexic( x, q3, q2, q1, q0, p, dp );
+      if ( isZero(p) ) { converged = true; break; }
+      Real dx = p/dp;
+      x        -= dx;
+      converged = warmConverged( dx, dx0, x, 2 );
+      dx0       = dx;
+    }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_NEWTON_ITER, iter );
+    return converged;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // data needed to complete a quartic with only complex roots
+  // once the root of the hexic is known
+  template <typename Real>
+  struct QuarticHexic {
+    Real q3, q2, q1, q0;  // scaled monic quartic, coefficients of the hexic
+    Real scale;
+    Real A3, A2, A1, A0;  // monic quartic
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   /*
   ||       _       __ _       _
   ||    __| | ___ / _| | __ _| |_ ___
@@ -350,22 +422,45 @@ namespace PolynomialRoots {
 
 
   /*\
-   *  Calculate the zeros of the quartic a*z^4 + b*z^3 + c*z^2 + d*x + e.
+   *  Calculate the zeros of the quartic A*z^4 + B*z^3 + C*z^2 + D*x + E.
+   *  The roots are stored in r0..r3 with the encoding used by class Quartic,
+   *  the number of iterations is returned in iter.
+   *  If realOnly is true and the quartic has no real roots the complex
+   *  roots are not computed (ncplx = 4 and r0..r3 are 0).
+   *  If hexic is not NULL and the complex roots need the iteration on the
+   *  hexic, the data of the iteration are stored in *hexic, ncplx = 4 and
+   *  false is returned: the roots are completed by the caller.
   \*/
 
-  void
-  Quartic::findRoots() {
-    valueType const & A = ABCDE[0];
-    valueType const & B = ABCDE[1];
-    valueType const & C = ABCDE[2];
-    valueType const & D = ABCDE[3];
-    valueType const & E = ABCDE[4];
+  template <typename Real>
+  static
+  bool
+  solveQuartic(
+    Real        A,
+    Real        B,
+    Real        C,
+    Real        D,
+    Real        E,
+    Real      & r0,
+    Real      & r1,
+    Real      & r2,
+    Real      & r3,
+    indexType & nreal,
+    indexType & ncplx,
+    indexType & iter,
+    bool        realOnly = false,
+    QuarticHexic<Real> * hexic = NULL
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
 
+    r0 = r1 = r2 = r3 = 0;
     iter = nreal = ncplx = 0;
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_SOLVES, 1 );
 
     // special cases
     if ( isZero(A) ) {
-      Cubic csolve( B, C, D, E );
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_CUBIC, 1 );
+      CubicT<Real> csolve( B, C, D, E );
       nreal = csolve.numRoots();
       switch ( nreal ) {
         case 3: r2 = csolve.real_root2();
@@ -373,10 +468,11 @@ namespace PolynomialRoots {
         case 1: r0 = csolve.real_root0();
       }
       if ( csolve.complexRoots() ) { ncplx = 2; nreal -= 2; }
-      return;
+      return true;
     }
     if ( isZero(E) ) {
-      Cubic csolve( A, B, C, D );
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_CUBIC, 1 );
+      CubicT<Real> csolve( A, B, C, D );
       nreal = csolve.numRoots();
       r0 = r1 = r2 = r3 = 0;
       switch ( nreal ) {
@@ -391,19 +487,20 @@ namespace PolynomialRoots {
         if ( r2 < r1 ) std::swap(r1,r2);
         if ( r1 < r0 ) std::swap(r0,r1);
       }
-      return;
+      return true;
     }
     if ( isZero(B) && isZero(D) ) { // biquadratic case
       // A x^4 + C x^2 + E
-      Quadratic qsolve( A, C, E ) ;
-      valueType x = qsolve.real_root0() ;
-      valueType y = qsolve.real_root1() ;
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_BIQUADRATIC, 1 );
+      QuadraticT<Real> qsolve( A, C, E ) ;
+      Real x = qsolve.real_root0() ;
+      Real y = qsolve.real_root1() ;
       if ( qsolve.complexRoots() ) {
         // complex conjugate pair biquadratic roots x +/- iy.
         ncplx = 4;
         x /= 2; // re
         y /= 2; // im
-        valueType z = hypot(x,y);
+        Real z = hypot(x,y);
         y = sqrt(z - x);
         x = sqrt(z + x);
         r0 = -x;
@@ -427,7 +524,7 @@ namespace PolynomialRoots {
           r0 = 0; r1 = x; r2 = 0; r3 = y; // 2 x (real,imaginary)
         }
       }
-      return;
+      return true;
     }
 
     /*
@@ -437,11 +534,11 @@ namespace PolynomialRoots {
     .. (due to underflow in the coefficients).
     */
 
-    valueType const A3 = B/A;
-    valueType const A2 = C/A;
-    valueType const A1 = D/A;
-    valueType const A0 = E/A;
-    valueType q0, q1, q2, q3, scale;
+    Real const A3 = B/A;
+    Real const A2 = C/A;
+    Real const A1 = D/A;
+    Real const A0 = E/A;
+    Real q0, q1, q2, q3, scale;
     indexType i_case;
     scaleQuarticMonicPolynomial( A3, A2, A1, A0, q3, q2, q1, q0, i_case, scale );
 
@@ -486,19 +583,19 @@ namespace PolynomialRoots {
     ..        Same of what has been said under 2) but with x = u.
     */
 
-    valueType c2 = 3 * (q3/4);
-    valueType c1 = q2/2;
-    valueType c0 = q1/4;
+    Real c2 = 3 * (q3/4);
+    Real c1 = q2/2;
+    Real c0 = q1/4;
 
-    Cubic qsolve( 1, c2, c1, c0 );
-    valueType u = qsolve.real_root0(); // root according to paper
-    valueType t = qsolve.real_root1();
-    valueType s = qsolve.real_root2();
+    CubicT<Real> qsolve( 1, c2, c1, c0 );
+    Real u = qsolve.real_root0(); // root according to paper
+    Real t = qsolve.real_root1();
+    Real s = qsolve.real_root2();
 
     if ( !qsolve.complexRoots() ) {
-      valueType Qs = evalMonicQuartic( s, q3, q2, q1, q0 );
-      valueType Qu = evalMonicQuartic( u, q3, q2, q1, q0 );
-      valueType tmp = q0 >= 0 ? 0 : 2; // segno di A0??
+      Real Qs = evalMonicQuartic( s, q3, q2, q1, q0 );
+      Real Qu = evalMonicQuartic( u, q3, q2, q1, q0 );
+      Real tmp = q0 >= 0 ? 0 : 2; // segno di A0??
       nreal = 1;
       if ( Qs < 0 && Qu < 0 ) {
         if ( Qs < Qu ) r3 = s < 0 ?  tmp :  2;
@@ -513,10 +610,10 @@ namespace PolynomialRoots {
         // check for astrological combination when s or u are root of the quartic
         /*
         DO NOT WORK
-        valueType epsi = 10 * ( 1 + std::abs(q3) +
-                                    std::abs(q2) +
-                                    std::abs(q1) +
-                                    std::abs(q0) ) * machepsi;
+        Real epsi = 10 * ( 1 + abs(q3) +
+                               abs(q2) +
+                               abs(q1) +
+                               abs(q0) ) * machepsi;
         if      ( Qs <= epsi ) r3 = s;
         else if ( Qu <= epsi ) r3 = u;
         else                   nreal = 0;
@@ -527,9 +624,9 @@ namespace PolynomialRoots {
       }
     } else {
       // one single real root (only 1 minimum)
-      valueType Qs = evalMonicQuartic( s, q3, q2, q1, q0 );
+      Real Qs = evalMonicQuartic( s, q3, q2, q1, q0 );
       if ( Qs <= 0 ) {
-        valueType tmp = q0 >= 0 ? 0 : 2;
+        Real tmp = q0 >= 0 ? 0 : 2;
         r3 = u > 0 ? -tmp : -2;
         nreal = 1;
       }
@@ -548,6 +645,7 @@ namespace PolynomialRoots {
     ..  oscillation brackets.
     */
     if ( nreal > 0 ) {
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_REAL_ROOT, 1 );
       iter += zeroQuarticByNewtonBisection( q3, q2, q1, q0, r3 );
       r3 *= scale;
 
@@ -560,7 +658,7 @@ namespace PolynomialRoots {
       */
       deflateQuarticPolynomial( A, B, C, D, E, r3, q2, q1, q0 );
 
-      Cubic csolve( A, q2, q1, q0 );
+      CubicT<Real> csolve( A, q2, q1, q0 );
       r0 = csolve.real_root0();
       r1 = csolve.real_root1();
       r2 = csolve.real_root2();
@@ -573,6 +671,10 @@ namespace PolynomialRoots {
         if ( r1 > r2 ) std::swap( r1, r2 );
         if ( r0 > r1 ) std::swap( r0, r1 );
       }
+    } else if ( realOnly ) {
+      // no real roots, skip the computation of the complex ones
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_REAL_ONLY_EXIT, 1 );
+      ncplx = 4;
     } else {
       /*
       .. If no real roots have been found by now, only complex roots are
@@ -593,52 +695,32 @@ namespace PolynomialRoots {
 
       bool iterate = notZero || (!notZero && minimum);
 
-      valueType a, b, c, d;
+      Real a, b, c, d;
       if ( iterate ) {
-        valueType x = q3 >= 0 ? 2 : -2; // initial root -> target = smaller mag root
-        iter += zeroHexicByNewtonBisection( q3, q2, q1, q0, x );
-
-        a = x*scale;   // 1st real component -> a
-        b = -A3/2 - a; // 2nd real component -> b
-
-        x = 4 * a + A3; // Q'''(a)
-        valueType y = x + 2*A3;
-        y = y * a + 2*A2; // Q'(a)
-        y = y * a + A1;
-        y /= x;
-        if ( y < 0 ) y = 0; // ensure Q'(a) / Q'''(a) >= 0
-
-        x = 4 * b + A3; // Q'''(b)
-        valueType z = x + 2*A3;
-        z = z * b + 2*A2; // Q'(b)
-        z = z * b + A1;
-        z /= x;
-        if ( z < 0 ) z = 0; // ensure Q'(b) / Q'''(b) >= 0
-
-        c = a * a;              // store a^2 for later
-        d = b * b;              // store b^2 for later
-        valueType ss = c + y;   // magnitude^2 of (a + iy) root
-        valueType tt = d + z;   // magnitude^2 of (b + iz) root
-
-        if ( ss > tt ) {         // minimize imaginary error
-          c = sqrt(y);           // 1st imaginary component -> c
-          d = sqrt(A0 / ss - d); // 2nd imaginary component -> d
-        } else {
-          c = sqrt(A0 / tt - c); // 1st imaginary component -> c
-          d = sqrt(z);           // 2nd imaginary component -> d
+        POLYNOMIAL_ROOTS_COUNT( QUARTIC_HEXIC, 1 );
+        if ( hexic != NULL ) {
+          hexic->q3    = q3; hexic->q2 = q2; hexic->q1 = q1; hexic->q0 = q0;
+          hexic->scale = scale;
+          hexic->A3    = A3; hexic->A2 = A2; hexic->A1 = A1; hexic->A0 = A0;
+          ncplx = 4;
+          return false;
         }
-
+        Real x = q3 >= 0 ? 2 : -2; // initial root -> target = smaller mag root
+        iter += zeroHexicByNewtonBisection( q3, q2, q1, q0, x );
+        a = x*scale; // 1st real component -> a
+        quarticComplexParts( a, A3, A2, A1, A0, b, c, d );
       } else { // no bisection -> real components equal
+        POLYNOMIAL_ROOTS_COUNT( QUARTIC_EQUAL_REAL_PARTS, 1 );
 
         a = -A3/4; // 1st real component -> a
         b = a;     // 2nd real component -> b = a
 
-        valueType x = a + A3;
+        Real x = a + A3;
         x = x * a + A2; // Q(a)
         x = x * a + A1;
         x = x * a + A0;
-        valueType y = A2/2 - 3*(a*a); // Q''(a) / 2
-        valueType z = y * y - x;
+        Real y = A2/2 - 3*(a*a); // Q''(a) / 2
+        Real z = y * y - x;
         z = z > 0 ? sqrt(z) : 0;     // force discriminant to be >= 0
                                      // square root of discriminant
         y = y > 0 ? y + z : y - z;   // larger magnitude root
@@ -652,10 +734,475 @@ namespace PolynomialRoots {
       else if (a < b) { r0 = b; r1 = d; r2 = a; r3 = c; }
       else            { r0 = a; r1 = c; r2 = a; r3 = d; }
     }
+    return true;
+  }
+
+  template <typename Real>
+  void
+  QuarticT<Real>::findRoots() {
+    solveQuartic(
+      ABCDE[0], ABCDE[1], ABCDE[2], ABCDE[3], ABCDE[4],
+      r0, r1, r2, r3, nreal, ncplx, iter
+    );
+  }
+
+  /*\
+   *  Calculate the zeros of the quartic A*z^4 + B*z^3 + C*z^2 + D*x + E
+   *  starting from the roots of the previous quartic. Return false (and
+   *  leave the roots untouched) if the roots must be computed by findRoots.
+  \*/
+
+  template <typename Real>
+  bool
+  QuarticT<Real>::warmRoots() {
+    valueType const machepsi = machineEpsilon<valueType>();
+    valueType const & A = ABCDE[0];
+    valueType const & B = ABCDE[1];
+    valueType const & C = ABCDE[2];
+    valueType const & D = ABCDE[3];
+    valueType const & E = ABCDE[4];
+
+    // the special cases of solveQuartic are not warm started
+    bool ok = nreal+ncplx == 4 && !isZero(A) && !isZero(E) &&
+              !(isZero(B) && isZero(D));
+
+    valueType const A3 = B/A;
+    valueType const A2 = C/A;
+    valueType const A1 = D/A;
+    valueType const A0 = E/A;
+    valueType x0(0), x1(0), x2(0), x3(0);
+    indexType it = 0;
+
+    if ( ok && nreal > 0 ) {
+      // the largest real root of the quartic, then the deflated cubic
+      // starting from the next root, as in solveQuartic
+      x3 = r3;
+      ok = zeroQuarticWarmStart( A3, A2, A1, A0, x3, it ) && !isZero(x3);
+      if ( ok ) {
+        valueType b2, b1, b0;
+        deflateQuarticPolynomial( A, B, C, D, E, x3, b2, b1, b0 );
+        valueType aa = b2/A;
+        valueType bb = b1/A;
+        valueType cc = b0/A;
+        indexType nr, it3;
+        bool      cp, db;
+        x2 = r2;
+        ok = !isZero(cc) && NewtonWarmStart( aa, bb, cc, x2, it3 ) && !isZero(x2);
+        if ( ok ) {
+          cubicDeflateAndSolve( aa, cc, x0, x1, x2, nr, cp, db );
+          ok = nreal == (cp ? 2 : 4); // the same number of real roots
+        }
+        if ( ok ) {
+          if ( x2 > x3 ) std::swap( x2, x3 );
+          if ( !cp ) {
+            if ( x1 > x2 ) std::swap( x1, x2 );
+            if ( x0 > x1 ) std::swap( x0, x1 );
+          }
+        }
+      }
+    } else if ( ok ) {
+      // only complex roots: the real part of a pair is the start of the
+      // iterations on the hexic, the roots are checked by the residual
+      // because the real roots are not searched
+      valueType q0, q1, q2, q3, scale;
+      indexType i_case;
+      scaleQuarticMonicPolynomial( A3, A2, A1, A0, q3, q2, q1, q0, i_case, scale );
+      valueType s = q3/2;
+      valueType t = s * s - q2;
+      valueType u = s * t + q1;
+      bool minimum;
+      if ( !isZero(q3) ) {
+        s = q1 / q3;
+        minimum = q0 > s * s;
+      } else {
+        minimum = 4 * q0 > q2 * q2;
+      }
+      ok = abs(u) >= machepsi || minimum; // the hexic is iterated
+      valueType x = (q3 >= 0 ? r0 : r2)/scale;
+      ok = ok && zeroHexicWarmStart( q3, q2, q1, q0, x, it );
+      if ( ok ) {
+        valueType a = x*scale, b, c, d;
+        quarticComplexParts( a, A3, A2, A1, A0, b, c, d );
+        if      (a > b) { x0 = a; x1 = c; x2 = b; x3 = d; }
+        else if (a < b) { x0 = b; x1 = d; x2 = a; x3 = c; }
+        else            { x0 = a; x1 = c; x2 = a; x3 = d; }
+        complexType z[2] = { complexType(x0,x1), complexType(x2,x3) };
+        for ( indexType k = 0; k < 2 && ok; ++k ) {
+          valueType az    = abs(z[k]);
+          valueType bound = (((abs(A)*az+abs(B))*az+abs(C))*az+abs(D))*az+abs(E);
+          ok = abs(evalPolyC( ABCDE, 4, z[k] )) <= 100 * machepsi * bound;
+        }
+      }
+    }
+
+    if ( !ok ) {
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_WARM_FALLBACK, 1 );
+      return false;
+    }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_SOLVES, 1 );
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_WARM, 1 );
+    r0   = x0;
+    r1   = x1;
+    r2   = x2;
+    r3   = x3;
+    iter = it;
+    return true;
+  }
+
+  // Newton correction p(x)/p'(x) of the quartic p with coefficients ABCDE
+  template <typename Real>
+  static
+  inline
+  Real
+  quarticNewtonStep( Real const ABCDE[5], Real x ) {
+    Real p  = ABCDE[0];
+    Real dp = 0;
+    for ( indexType i = 1; i < 5; ++i ) { dp = dp * x + p; p = p * x + ABCDE[i]; }
+    return isZero(dp) ? dp : p/dp;
   }
 
+  /*\
+   *  Calculate the zeros of the quartic A*z^4 + B*z^3 + C*z^2 + D*x + E
+   *  by the factorization of the scaled monic quartic
+   *
+   *    x^4 + a*x^3 + b*x^2 + c*x + d = (x^2 + a/2*x + y/2)^2 - (R*x + S)^2
+   *
+   *  where y is the largest real root of the resolvent cubic
+   *
+   *    y^3 - b*y^2 + (a*c - 4*d)*y - (a^2*d - 4*b*d + c^2) = 0
+   *
+   *  and R^2 = a^2/4 - b + y, S^2 = y^2/4 - d, R*S = (a*y/2 - c)/2. The
+   *  larger of R, S is computed by the square root and the other from
+   *  R*S, the larger constant term of the two quadratic factors directly
+   *  and the other from their product d. The real roots are polished by
+   *  a Newton step on the quartic, then each root must have a residual
+   *  at the level of the rounding. Return false (and leave the roots
+   *  untouched) if the roots must be computed by findRoots.
+  \*/
+
+  template <typename Real>
+  bool
+  QuarticT<Real>::closedFormRoots() {
+    valueType const machepsi = machineEpsilon<valueType>();
+    valueType const & A = ABCDE[0];
+    valueType const & B = ABCDE[1];
+    valueType const & C = ABCDE[2];
+    valueType const & D = ABCDE[3];
+    valueType const & E = ABCDE[4];
+
+    // special cases of solveQuartic
+    if ( isZero(A) || isZero(E) || (isZero(B) && isZero(D)) ) return false;
+
+    valueType q0, q1, q2, q3, scale;
+    indexType i_case;
+    scaleQuarticMonicPolynomial( B/A, C/A, D/A, E/A, q3, q2, q1, q0, i_case, scale );
+
+    valueType y;
+    bool ok = cubicClosedFormRoot( -q2, q3*q1 - 4*q0, (4*q2 - q3*q3)*q0 - q1*q1, y, true );
+
+    QuadraticT<valueType> f[2];
+    valueType x[4], R(0), S(0);
+    if ( ok ) {
+      valueType R2 = q3*q3/4 - q2 + y;
+      valueType S2 = y*y/4 - q0;
+      valueType RS = (q3*y/2 - q1)/2;
+      if ( R2 >= S2 ) {
+        if ( R2 > 0 ) { R = sqrt(R2); S = RS/R; }
+      } else {
+        S = sqrt(S2); R = RS/S;
+      }
+      // x^2 + (a/2 + R)*x + (y/2 + S) and x^2 + (a/2 - R)*x + (y/2 - S)
+      valueType c1 = y/2 + S;
+      valueType c2 = y/2 - S;
+      if ( abs(c1) >= abs(c2) ) { if ( !isZero(c1) ) c2 = q0/c1; }
+      else                      c1 = q0/c2;
+      f[0].setup( 1, q3/2 + R, c1 );
+      f[1].setup( 1, q3/2 - R, c2 );
+
+      // the roots of the two factors and the residual of each one
+      for ( indexType k = 0; k < 2 && ok; ++k ) {
+        valueType re = f[k].real_root0()*scale;
+        valueType im = f[k].real_root1()*scale;
+        if ( f[k].complexRoots() ) { // the conjugate root has the same residual
+          complexType z( re, im );
+          valueType az    = sqrt(std::norm(z));
+          valueType bound = 100 * machepsi *
+                            ((((abs(A)*az+abs(B))*az+abs(C))*az+abs(D))*az+abs(E));
+          ok = std::norm(evalPolyC( ABCDE, 4, z )) <= bound*bound;
+        } else { // a Newton step on the quartic recovers the rounding of the factor
+          re -= quarticNewtonStep( ABCDE, re );
+          im -= quarticNewtonStep( ABCDE, im );
+          if ( re > im ) std::swap( re, im );
+          valueType const xr[2] = { re, im };
+          for ( indexType i = 0; i < 2 && ok; ++i ) {
+            valueType ax    = abs(xr[i]);
+            valueType bound = (((abs(A)*ax+abs(B))*ax+abs(C))*ax+abs(D))*ax+abs(E);
+            ok = abs(evalPoly( ABCDE, 4, xr[i] )) <= 100 * machepsi * bound;
+          }
+        }
+        x[2*k]   = re;
+        x[2*k+1] = im;
+      }
+    }
+
+    if ( !ok ) {
+      POLYNOMIAL_ROOTS_COUNT( QUARTIC_CLOSED_FORM_FALLBACK, 1 );
+      return false;
+    }
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_SOLVES, 1 );
+    POLYNOMIAL_ROOTS_COUNT( QUARTIC_CLOSED_FORM, 1 );
+
+    // the layout of solveQuartic: the complex pairs first, with the
+    // largest real part first, then the real roots in ascending order
+    ncplx = (f[0].complexRoots() ? 2 : 0) + (f[1].complexRoots() ? 2 : 0);
+    nreal = 4-ncplx;
+    if ( ncplx == 0 ) {
+      std::sort( x, x+4 );
+    } else if ( ncplx == 2 ? f[1].complexRoots() : x[0] < x[2] ) {
+      std::swap( x[0], x[2] );
+      std::swap( x[1], x[3] );
+    }
+    r0   = x[0];
+    r1   = x[1];
+    r2   = x[2];
+    r3   = x[3];
+    iter = 1;
+    return true;
+  }
+
+  /*
+  ||   _           _       _
+  ||  | |__   __ _| |_ ___| |__
+  ||  | '_ \ / _` | __/ __| '_ \
+  ||  | |_) | (_| | || (__| | | |
+  ||  |_.__/ \__,_|\__\___|_| |_|
+  */
+
+  // number of quartics with only complex roots completed in lockstep
+  static indexType const numLanes = 16;
+
+  // the scaled hexics of the lanes (x^4+1 for the padding lanes)
+  template <typename Real>
+  struct HexicLanes {
+    Real const * q3;
+    Real const * q2;
+    Real const * q1;
+    Real const * q0;
+
+    void
+    operator () ( indexType l, Real x, Real & p, Real & dp ) const
+    { evalHexic( x, q3[l], q2[l], q1[l], q0[l], p, dp ); }
+
+    Real
+    operator () ( indexType l, Real x ) const
+    { return evalHexic( x, q3[l], q2[l], q1[l], q0[l] ); }
+  };
+
+  /*\
+   *  Real and imaginary parts of the roots of the numLanes monic quartics
+   *  x^4 + A3[l] * x^3 + A2[l] * x^2 + A1[l] * x + A0[l] with only complex
+   *  roots from the root x[l] of the scaled hexic, as in solveQuartic.
+   *  Both choices of the imaginary parts are computed in the first loop
+   *  and the second loop only selects, so that both loops vectorize.
+  \*/
+
+  template <typename Real>
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  quarticComplexRootsLanes(
+    Real const      x[],
+    Real const      scale[],
+    Real const      A3[],
+    Real const      A2[],
+    Real const      A1[],
+    Real const      A0[],
+    Real            r0[],
+    Real            r1[],
+    Real            r2[],
+    Real            r3[]
+  ) {
+    Real a[numLanes], b[numLanes], ss[numLanes], tt[numLanes];
+    Real c1[numLanes], d1[numLanes], c2[numLanes], d2[numLanes];
+
+    for ( indexType l = 0; l < numLanes; ++l ) {
+      Real aa = x[l]*scale[l];  // 1st real component -> a
+      Real bb = -A3[l]/2 - aa;  // 2nd real component -> b
+      Real xa = 4 * aa + A3[l]; // Q'''(a)
+      Real y  = ((xa + 2*A3[l]) * aa + 2*A2[l]) * aa + A1[l]; // Q'(a)
+      y /= xa;
+      y  = y < 0 ? 0 : y;       // ensure Q'(a) / Q'''(a) >= 0
+      Real xb = 4 * bb + A3[l]; // Q'''(b)
+      Real z  = ((xb + 2*A3[l]) * bb + 2*A2[l]) * bb + A1[l]; // Q'(b)
+      z /= xb;
+      z  = z < 0 ? 0 : z;       // ensure Q'(b) / Q'''(b) >= 0
+      Real c = aa * aa;
+      Real d = bb * bb;
+      a[l]  = aa;
+      b[l]  = bb;
+      ss[l] = c + y; // magnitude^2 of (a + iy) root
+      tt[l] = d + z; // magnitude^2 of (b + iz) root
+      c1[l] = sqrt(y);
+      d1[l] = sqrt(A0[l] / ss[l] - d);
+      c2[l] = sqrt(A0[l] / tt[l] - c);
+      d2[l] = sqrt(z);
+    }
+
+    for ( indexType l = 0; l < numLanes; ++l ) {
+      bool first = ss[l] > tt[l]; // minimize imaginary error
+      Real c     = first ? c1[l] : c2[l];
+      Real d     = first ? d1[l] : d2[l];
+      bool swap  = a[l] < b[l];
+      r0[l] = swap ? b[l] : a[l];
+      r1[l] = swap ? d    : c;
+      r2[l] = swap ? a[l] : b[l];
+      r3[l] = swap ? c    : d;
+    }
+  }
+
+  // the two lane kernels, compiled for each SimdLevel and selected by runKernel
+  template <typename Real>
+  struct QuarticLanesKernel {
+    static
+    POLYNOMIAL_ROOTS_KERNEL
+    void
+    run(
+      indexType  m,
+      Real const q3[],
+      Real const q2[],
+      Real const q1[],
+      Real const q0[],
+      Real const scale[],
+      Real const A3[],
+      Real const A2[],
+      Real const A1[],
+      Real const A0[],
+      Real       x[],
+      indexType  iter[],
+      Real       r0[],
+      Real       r1[],
+      Real       r2[],
+      Real       r3[]
+    ) {
+      HexicLanes<Real> const eval = { q3, q2, q1, q0 };
+      NewtonBisectionLanes<
+        numLanes,
+        SolverStats::QUARTIC_NEWTON_ITER,
+        SolverStats::QUARTIC_BISECTION,
+        SolverStats::QUARTIC_BISECTION_ITER
+      >( m, eval, x, iter );
+      quarticComplexRootsLanes( x, scale, A3, A2, A1, A0, r0, r1, r2, r3 );
+    }
+  };
+
+  template <typename Real>
   void
-  Quartic::info( std::ostream & s ) const {
+  solveQuarticBatch(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real const      D[],
+    Real const      E[],
+    Real            r0[],
+    Real            r1[],
+    Real            r2[],
+    Real            r3[],
+    indexType       nreal[],
+    indexType       ncplx[]
+  ) {
+    Real      q3[numLanes], q2[numLanes], q1[numLanes], q0[numLanes];
+    Real      A3[numLanes], A2[numLanes], A1[numLanes], A0[numLanes];
+    Real      scale[numLanes], x[numLanes];
+    Real      rr0[numLanes], rr1[numLanes], rr2[numLanes], rr3[numLanes];
+    indexType idx[numLanes], iter[numLanes];
+    QuarticHexic<Real> hexic;
+    indexType i = 0;
+    while ( i < n ) {
+      // quartics needing the hexic iteration are packed in the lanes,
+      // the others are solved directly
+      indexType m = 0;
+      for ( ; i < n && m < numLanes; ++i ) {
+        indexType it;
+        if ( solveQuartic(
+               A[i], B[i], C[i], D[i], E[i],
+               r0[i], r1[i], r2[i], r3[i], nreal[i], ncplx[i], it, false, &hexic
+             ) ) continue;
+        q3[m]    = hexic.q3;
+        q2[m]    = hexic.q2;
+        q1[m]    = hexic.q1;
+        q0[m]    = hexic.q0;
+        A3[m]    = hexic.A3;
+        A2[m]    = hexic.A2;
+        A1[m]    = hexic.A1;
+        A0[m]    = hexic.A0;
+        scale[m] = hexic.scale;
+        x[m]     = q3[m] >= 0 ? 2 : -2; // initial root -> target = smaller mag root
+        idx[m++] = i;
+      }
+      if ( m == 0 ) continue;
+      // pad the last lanes with x^4+1
+      std::fill( q3+m, q3+numLanes, Real(0) ); std::fill( A3+m, A3+numLanes, Real(0) );
+      std::fill( q2+m, q2+numLanes, Real(0) ); std::fill( A2+m, A2+numLanes, Real(0) );
+      std::fill( q1+m, q1+numLanes, Real(0) ); std::fill( A1+m, A1+numLanes, Real(0) );
+      std::fill( q0+m, q0+numLanes, Real(1) ); std::fill( A0+m, A0+numLanes, Real(1) );
+      std::fill( scale+m, scale+numLanes, Real(1) );
+      std::fill( x+m, x+numLanes, Real(2) );
+      runKernel<QuarticLanesKernel<Real> >(
+        m, q3, q2, q1, q0, scale, A3, A2, A1, A0, x, iter, rr0, rr1, rr2, rr3
+      );
+      for ( indexType l = 0; l < m; ++l ) {
+        indexType k = idx[l];
+        r0[k] = rr0[l];
+        r1[k] = rr1[l];
+        r2[k] = rr2[l];
+        r3[k] = rr3[l];
+      }
+    }
+  }
+
+  template <typename Real>
+  indexType
+  solveQuarticReal(
+    Real A,
+    Real B,
+    Real C,
+    Real D,
+    Real E,
+    Real r[]
+  ) {
+    Real      r0, r1, r2, r3;
+    indexType nreal, ncplx, iter;
+    solveQuartic( A, B, C, D, E, r0, r1, r2, r3, nreal, ncplx, iter, true );
+    // the real roots follow the complex pairs, see class Quartic
+    Real const rr[] = { r0, r1, r2, r3 };
+    for ( indexType i = 0; i < nreal; ++i ) r[i] = rr[ncplx+i];
+    return nreal;
+  }
+
+  template <typename Real>
+  bool
+  solveQuarticInterval(
+    Real   A,
+    Real   B,
+    Real   C,
+    Real   D,
+    Real   E,
+    Real   lo,
+    Real   hi,
+    Real & x
+  ) {
+    if ( isZero(A) ) return solveCubicInterval( B, C, D, E, lo, hi, x );
+    // stationary points, roots of 4*A*x^3 + 3*B*x^2 + 2*C*x + D
+    Real const p[] = { A, B, C, D, E };
+    Real       st[3] = { 0, 0, 0 };
+    CubicT<Real> dsolve( 4*A, 3*B, 2*C, D );
+    indexType nst = dsolve.getRealRoots( st );
+    return firstRootInInterval( p, 4, st, nst, lo, hi, x );
+  }
+
+  template <typename Real>
+  void
+  QuarticT<Real>::info( std::ostream & s ) const {
     valueType const & A = ABCDE[0];
     valueType const & B = ABCDE[1];
     valueType const & C = ABCDE[2];
@@ -682,53 +1229,67 @@ namespace PolynomialRoots {
     s << '\n';
   }
 
+  template <typename Real>
   bool
-  Quartic::check( std::ostream & s ) const {
+  QuarticT<Real>::check( std::ostream & s ) const {
+    valueType const machepsi = machineEpsilon<valueType>();
     valueType const & A = ABCDE[0];
     valueType const & B = ABCDE[1];
     valueType const & C = ABCDE[2];
     valueType const & D = ABCDE[3];
     valueType const & E = ABCDE[4];
     bool ok = true;
-    valueType epsi = 10 * ( std::abs(A) +
-                            std::abs(B)+std::abs(C)+std::abs(D)+std::abs(E))*machepsi;
+    valueType epsi = 10 * ( abs(A) +
+                            abs(B)+abs(C)+abs(D)+abs(E))*machepsi;
     if ( ncplx > 0 ) {
-      valueType z0 = std::abs(eval( root0() ));
-      valueType z1 = std::abs(eval( root1() ));
+      valueType z0 = abs(eval( root0() ));
+      valueType z1 = abs(eval( root1() ));
       s << "|p(r0)| = " << z0 << "\n|p(r1)| = " << z1 << '\n';
-      ok = ok && std::abs(z0) < epsi && std::abs(z1) < epsi;
+      ok = ok && abs(z0) < epsi && abs(z1) < epsi;
     } else {
       if ( nreal > 0 ) {
         valueType z0 = eval( real_root0() );
         s << "p(r0) = " << z0 << '\n';
-        ok = ok && std::abs(z0) < epsi;
+        ok = ok && abs(z0) < epsi;
       }
       if ( nreal > 1 ) {
         valueType z1 = eval( real_root1() );
         s << "p(r1) = " << z1 << '\n';
-        ok = ok && std::abs(z1) < epsi;
+        ok = ok && abs(z1) < epsi;
       }
     }
     if ( ncplx > 2 ) {
-      valueType z2 = std::abs(eval( root2() ));
-      valueType z3 = std::abs(eval( root3() ));
+      valueType z2 = abs(eval( root2() ));
+      valueType z3 = abs(eval( root3() ));
       s << "|p(r2)| = " << z2 << "\n|p(r3)| = " << z3 << '\n';
-      ok = ok && std::abs(z2) < epsi && std::abs(z3) < epsi;
+      ok = ok && abs(z2) < epsi && abs(z3) < epsi;
     } else {
       if ( nreal > 2 || (ncplx > 0 && nreal > 0)  ) {
         valueType z2 = eval( real_root2() );
         s << "p(r2) = " << z2 << '\n';
-        ok = ok && std::abs(z2) < epsi;
+        ok = ok && abs(z2) < epsi;
       }
       if ( nreal > 3 || (ncplx > 0 && nreal > 1)  ) {
         valueType z3 = eval( real_root3() );
         s << "p(r3) = " << z3 << '\n';
-        ok = ok && std::abs(z3) < epsi;
+        ok = ok && abs(z3) < epsi;
       }
     }
     return ok;
   }
 
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                                 \
+  template class QuarticT<Real>;                                             \
+  template void solveQuarticBatch( indexType, Real const [], Real const [],  \
+                                   Real const [], Real const [],             \
+                                   Real const [], Real [], Real [], Real [],  \
+                                   Real [], indexType [], indexType [] ); \
+  template indexType solveQuarticReal( Real, Real, Real, Real, Real, Real [] ); \
+  template bool solveQuarticInterval( Real, Real, Real, Real, Real,            \
+                                      Real, Real, Real & );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
 }
 
 // EOF: PolynomialRoots-3-Quartic.cc
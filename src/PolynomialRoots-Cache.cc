@@ -0,0 +1,414 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include "PolynomialRoots-inline.hh"
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace PolynomialRoots {
+
+  /*\
+   *  The entries are in a fixed array of slots, an hash map gives the
+   *  slot of a key. A slot is replaced with the CLOCK policy: the hand
+   *  runs over the slots clearing the `referenced` bit set by the hits
+   *  and stops on the first slot not referenced since the last pass.
+  \*/
+
+  // kind of polynomial of an entry, first component of the key
+  enum { CACHE_CUBIC = 3, CACHE_QUARTIC = 4, CACHE_ROOTS = 5 };
+
+  template <typename Real>
+  struct RootsCacheEntry {
+    std::vector<Real> key;   // kind, degree, normalized coefficients
+    std::vector<Real> zeror; // roots of the normalized polynomial
+    std::vector<Real> zeroi;
+    int               info;  // numRoots() or the return value of roots()
+    bool              used;
+    bool              referenced;
+    RootsCacheEntry() : info(0), used(false), referenced(false) {}
+  };
+
+  // FNV-1a on the key converted to double, -0 and +0 have the same hash
+  template <typename Real>
+  static
+  std::size_t
+  hashKey( std::vector<Real> const & key ) {
+    unsigned long long h = 14695981039346656037ULL;
+    for ( std::size_t i = 0; i < key.size(); ++i ) {
+      double             x = double(key[i]+0);
+      unsigned long long bits;
+      std::memcpy( &bits, &x, sizeof(bits) );
+      for ( int k = 0; k < 8; ++k ) {
+        h ^= (bits >> (8*k)) & 0xFF;
+        h *= 1099511628211ULL;
+      }
+    }
+    return std::size_t(h);
+  }
+
+  template <typename Real>
+  static inline
+  bool
+  isFiniteValue( Real x )
+  { return x-x == 0; } // false for NaN and infinities
+
+  /*\
+   *  Exponent e of a power of two close to max |m[i-1]|^(1/i), i = 1..n.
+   *  Scaling m[i-1] by 2^(-e*i) is exact and a scale 2^k of the roots
+   *  changes e to e+k, so the normalized coefficients computed after this
+   *  step are the same. Return false if all the coefficients are zero.
+  \*/
+
+  template <typename Real>
+  static
+  bool
+  powerOfTwoScale( Real const m[], indexType n, int & e ) {
+    bool found = false;
+    for ( indexType i = 1; i <= n; ++i ) {
+      if ( isZero(m[i-1]) ) continue;
+      int ex;
+      frexp( m[i-1], &ex );
+      // floor((ex-1)/i), exponent of m[i-1]^(1/i)
+      int ei = ex >= 1 ? (ex-1)/i : -((i-ex)/i);
+      if ( !found || ei > e ) e = ei;
+      found = true;
+    }
+    return found;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename Real>
+  class RootsCacheT<Real>::Impl {
+  public:
+    typedef RootsCacheEntry<Real>                          Entry;
+    typedef std::unordered_map<std::size_t,indexType>      Map;
+
+    mutable std::mutex mtx;
+    std::vector<Entry> slots;
+    Map                map;
+    indexType          hand;
+    RootsCacheStats    stats;
+
+    explicit
+    Impl( indexType capacity )
+    : slots( std::size_t(capacity > 0 ? capacity : 1) )
+    , hand(0)
+    { reset(); }
+
+    void
+    reset() {
+      for ( std::size_t i = 0; i < slots.size(); ++i ) slots[i] = Entry();
+      map.clear();
+      hand = 0;
+      stats.hits = stats.misses = stats.evictions = stats.bypassed = 0;
+      stats.size = 0;
+    }
+
+    void
+    bypass() {
+      std::lock_guard<std::mutex> lock( mtx );
+      ++stats.bypassed;
+    }
+
+    // copy the roots of `key` scaled by `scale`, return false on a miss
+    bool
+    lookup(
+      std::vector<Real> const & key,
+      std::size_t               h,
+      Real                      scale,
+      Real                      zeror[],
+      Real                      zeroi[],
+      int                     & info
+    ) {
+      std::lock_guard<std::mutex> lock( mtx );
+      typename Map::const_iterator it = map.find( h );
+      if ( it == map.end() || slots[std::size_t(it->second)].key != key ) {
+        ++stats.misses;
+        return false;
+      }
+      Entry & e = slots[std::size_t(it->second)];
+      e.referenced = true;
+      for ( std::size_t i = 0; i < e.zeror.size(); ++i ) {
+        zeror[i] = e.zeror[i]*scale;
+        zeroi[i] = e.zeroi[i]*scale;
+      }
+      info = e.info;
+      ++stats.hits;
+      return true;
+    }
+
+    void
+    insert(
+      std::vector<Real> const & key,
+      std::size_t               h,
+      Real const                zeror[],
+      Real const                zeroi[],
+      indexType                 nroots,
+      int                       info
+    ) {
+      std::lock_guard<std::mutex> lock( mtx );
+      typename Map::iterator it = map.find( h );
+      // stored by another thread in the meanwhile
+      if ( it != map.end() && slots[std::size_t(it->second)].key == key ) return;
+
+      indexType n = indexType(slots.size());
+      while ( slots[std::size_t(hand)].referenced ) {
+        slots[std::size_t(hand)].referenced = false;
+        hand = (hand+1) % n;
+      }
+      indexType slot = hand;
+      hand = (hand+1) % n;
+
+      Entry & e = slots[std::size_t(slot)];
+      if ( e.used ) {
+        // the map may already point to a newer entry with the same hash
+        typename Map::iterator old = map.find( hashKey( e.key ) );
+        if ( old != map.end() && old->second == slot ) map.erase( old );
+        ++stats.evictions;
+      } else {
+        ++stats.size;
+      }
+      e.key.assign( key.begin(), key.end() );
+      e.zeror.assign( zeror, zeror+nroots );
+      e.zeroi.assign( zeroi, zeroi+nroots );
+      e.info       = info;
+      e.used       = true;
+      e.referenced = false;
+      map[h]       = slot;
+    }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename Real>
+  RootsCacheT<Real>::RootsCacheT( indexType capacity )
+  : impl( new Impl( capacity ) )
+  {}
+
+  template <typename Real>
+  RootsCacheT<Real>::~RootsCacheT()
+  { delete impl; }
+
+  template <typename Real>
+  indexType
+  RootsCacheT<Real>::getCapacity() const
+  { return indexType(impl->slots.size()); }
+
+  template <typename Real>
+  RootsCacheStats
+  RootsCacheT<Real>::getStats() const {
+    std::lock_guard<std::mutex> lock( impl->mtx );
+    return impl->stats;
+  }
+
+  template <typename Real>
+  void
+  RootsCacheT<Real>::clear() {
+    std::lock_guard<std::mutex> lock( impl->mtx );
+    impl->reset();
+  }
+
+  /*\
+   *  Cubic: key is the monic cubic scaled by `scaleCubicMonicPolynomial`,
+   *  the roots of the scaled cubic are stored.
+  \*/
+
+  template <typename Real>
+  indexType
+  RootsCacheT<Real>::cubic(
+    Real a,
+    Real b,
+    Real c,
+    Real d,
+    Real zeror[],
+    Real zeroi[]
+  ) {
+    typedef CubicT<Real> Cubic;
+    Real      na = 0, nb = 0, nc = 0, scale = 0;
+    indexType i_case;
+    int       e  = 0;
+    bool      ok = !isZero(a);
+    if ( ok ) {
+      Real m[3] = { b/a, c/a, d/a };
+      ok = powerOfTwoScale( m, 3, e );
+      if ( ok ) {
+        scaleCubicMonicPolynomial(
+          ldexp(m[0],-e), ldexp(m[1],-2*e), ldexp(m[2],-3*e),
+          na, nb, nc, i_case, scale
+        );
+        scale = ldexp(scale,e);
+      }
+    }
+    ok = ok && scale > 0 && isFiniteValue( scale ) &&
+         isFiniteValue( na ) && isFiniteValue( nb ) && isFiniteValue( nc );
+
+    if ( ok ) {
+      std::vector<Real> key(5);
+      key[0] = CACHE_CUBIC; key[1] = 3; key[2] = na; key[3] = nb; key[4] = nc;
+      std::size_t h = hashKey( key );
+      int info;
+      if ( impl->lookup( key, h, scale, zeror, zeroi, info ) ) return indexType(info);
+      Cubic     cubic( 1, na, nb, nc );
+      indexType nr = cubic.numRoots();
+      if ( nr > 0 ) cubic.getRoot0( zeror[0], zeroi[0] );
+      if ( nr > 1 ) cubic.getRoot1( zeror[1], zeroi[1] );
+      if ( nr > 2 ) cubic.getRoot2( zeror[2], zeroi[2] );
+      impl->insert( key, h, zeror, zeroi, nr, int(nr) );
+      for ( indexType i = 0; i < nr; ++i ) { zeror[i] *= scale; zeroi[i] *= scale; }
+      return nr;
+    }
+
+    impl->bypass();
+    Cubic     cubic( a, b, c, d );
+    indexType nr = cubic.numRoots();
+    if ( nr > 0 ) cubic.getRoot0( zeror[0], zeroi[0] );
+    if ( nr > 1 ) cubic.getRoot1( zeror[1], zeroi[1] );
+    if ( nr > 2 ) cubic.getRoot2( zeror[2], zeroi[2] );
+    return nr;
+  }
+
+  /*\
+   *  Quartic: key is the monic quartic scaled by
+   *  `scaleQuarticMonicPolynomial`, the roots of the scaled quartic are
+   *  stored.
+  \*/
+
+  template <typename Real>
+  indexType
+  RootsCacheT<Real>::quartic(
+    Real a,
+    Real b,
+    Real c,
+    Real d,
+    Real e,
+    Real zeror[],
+    Real zeroi[]
+  ) {
+    typedef QuarticT<Real> Quartic;
+    Real      q3 = 0, q2 = 0, q1 = 0, q0 = 0, scale = 0;
+    indexType i_case;
+    int       ex = 0;
+    bool      ok = !isZero(a);
+    if ( ok ) {
+      Real m[4] = { b/a, c/a, d/a, e/a };
+      ok = powerOfTwoScale( m, 4, ex );
+      if ( ok ) {
+        scaleQuarticMonicPolynomial(
+          ldexp(m[0],-ex), ldexp(m[1],-2*ex), ldexp(m[2],-3*ex), ldexp(m[3],-4*ex),
+          q3, q2, q1, q0, i_case, scale
+        );
+        scale = ldexp(scale,ex);
+      }
+    }
+    ok = ok && scale > 0 && isFiniteValue( scale ) &&
+         isFiniteValue( q3 ) && isFiniteValue( q2 ) &&
+         isFiniteValue( q1 ) && isFiniteValue( q0 );
+
+    if ( ok ) {
+      std::vector<Real> key(6);
+      key[0] = CACHE_QUARTIC; key[1] = 4;
+      key[2] = q3; key[3] = q2; key[4] = q1; key[5] = q0;
+      std::size_t h = hashKey( key );
+      int info;
+      if ( impl->lookup( key, h, scale, zeror, zeroi, info ) ) return indexType(info);
+      Quartic   quartic( 1, q3, q2, q1, q0 );
+      indexType nr = quartic.numRoots();
+      if ( nr > 0 ) quartic.getRoot0( zeror[0], zeroi[0] );
+      if ( nr > 1 ) quartic.getRoot1( zeror[1], zeroi[1] );
+      if ( nr > 2 ) quartic.getRoot2( zeror[2], zeroi[2] );
+      if ( nr > 3 ) quartic.getRoot3( zeror[3], zeroi[3] );
+      impl->insert( key, h, zeror, zeroi, nr, int(nr) );
+      for ( indexType i = 0; i < nr; ++i ) { zeror[i] *= scale; zeroi[i] *= scale; }
+      return nr;
+    }
+
+    impl->bypass();
+    Quartic   quartic( a, b, c, d, e );
+    indexType nr = quartic.numRoots();
+    if ( nr > 0 ) quartic.getRoot0( zeror[0], zeroi[0] );
+    if ( nr > 1 ) quartic.getRoot1( zeror[1], zeroi[1] );
+    if ( nr > 2 ) quartic.getRoot2( zeror[2], zeroi[2] );
+    if ( nr > 3 ) quartic.getRoot3( zeror[3], zeroi[3] );
+    return nr;
+  }
+
+  /*\
+   *  Generic polynomial: key is the monic polynomial with the variable
+   *  scaled by the power of two of `powerOfTwoScale`, only the successful
+   *  solutions are stored.
+  \*/
+
+  template <typename Real>
+  int
+  RootsCacheT<Real>::roots(
+    Real const op[],
+    indexType  Degree,
+    Real       zeror[],
+    Real       zeroi[]
+  ) {
+    bool ok = Degree >= 1 && !isZero(op[0]) && isFiniteValue( op[0] );
+    std::vector<Real> key;
+    int  e     = 0;
+    Real scale = 0;
+    if ( ok ) {
+      key.resize( std::size_t(Degree+2) );
+      key[0] = CACHE_ROOTS;
+      key[1] = Real(Degree);
+      for ( indexType i = 1; i <= Degree; ++i ) key[std::size_t(i+1)] = op[i]/op[0];
+      ok = powerOfTwoScale( &key[2], Degree, e );
+    }
+    if ( ok ) {
+      scale = ldexp( Real(1), e );
+      for ( indexType i = 1; i <= Degree; ++i ) {
+        Real & m = key[std::size_t(i+1)];
+        m  = ldexp( m, -e*i );
+        ok = ok && isFiniteValue( m );
+      }
+    }
+    if ( !ok ) {
+      impl->bypass();
+      return PolynomialRoots::roots( op, Degree, zeror, zeroi );
+    }
+
+    std::size_t h = hashKey( key );
+    int info;
+    if ( impl->lookup( key, h, scale, zeror, zeroi, info ) ) return info;
+
+    std::vector<Real> sop( std::size_t(Degree+1) );
+    sop[0] = 1;
+    for ( indexType i = 1; i <= Degree; ++i ) sop[std::size_t(i)] = key[std::size_t(i+1)];
+    info = PolynomialRoots::roots( &sop.front(), Degree, zeror, zeroi );
+    if ( info == 0 ) impl->insert( key, h, zeror, zeroi, Degree, info );
+    for ( indexType i = 0; i < Degree; ++i ) { zeror[i] *= scale; zeroi[i] *= scale; }
+    return info;
+  }
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real) \
+  template class RootsCacheT<Real>;
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
+}
+
+// EOF: PolynomialRoots-Cache.cc
@@ -0,0 +1,76 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+
+#include <atomic>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#endif
+
+namespace PolynomialRoots {
+
+  static char const * levelNames[] = { "generic", "SSE4.2", "AVX2", "AVX-512" };
+
+  // best level supported by the CPU, cpuid is read by __builtin_cpu_supports
+  static
+  SimdLevel
+  detectSimdLevel() {
+    #ifdef POLYNOMIAL_ROOTS_DISPATCH
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx512f")  &&
+         __builtin_cpu_supports("avx512vl") &&
+         __builtin_cpu_supports("avx512dq") ) return SIMD_AVX512;
+    if ( __builtin_cpu_supports("avx2") )   return SIMD_AVX2;
+    if ( __builtin_cpu_supports("sse4.2") ) return SIMD_SSE42;
+    #endif
+    return SIMD_GENERIC;
+  }
+
+  // both are set when the library is loaded, before that they are zero
+  // (SIMD_GENERIC) so a solver called by another static initializer is safe;
+  // activeLevel is atomic since setSimdLevel can run while other threads
+  // solve, a kernel running there keeps the level it has read
+  static SimdLevel        maxLevel = detectSimdLevel();
+  static std::atomic<int> activeLevel( maxLevel );
+
+  SimdLevel
+  simdLevel()
+  { return SimdLevel( activeLevel.load( std::memory_order_relaxed ) ); }
+
+  SimdLevel simdLevelMax() { return maxLevel; }
+
+  char const *
+  simdLevelName( SimdLevel l ) {
+    return l >= SIMD_GENERIC && l <= SIMD_AVX512 ? levelNames[l] : "unknown";
+  }
+
+  SimdLevel
+  setSimdLevel( SimdLevel l ) {
+    SimdLevel level = l < SIMD_GENERIC ? SIMD_GENERIC : ( l > maxLevel ? maxLevel : l );
+    activeLevel.store( level, std::memory_order_relaxed );
+    return level;
+  }
+
+}
+
+// EOF: PolynomialRoots-Dispatch.cc
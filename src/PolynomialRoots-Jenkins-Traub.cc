@@ -31,17 +31,14 @@
 //
 
 #include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wglobal-constructors"
-#pragma GCC diagnostic ignored "-Wvla-extension"
-#pragma GCC diagnostic ignored "-Wvla"
 #pragma GCC diagnostic ignored "-Wunused-function"
 #endif
 #ifdef __clang__
 #pragma clang diagnostic ignored "-Wglobal-constructors"
-#pragma clang diagnostic ignored "-Wvla-extension"
-#pragma clang diagnostic ignored "-Wvla"
 #pragma clang diagnostic ignored "-Wunused-function"
 #endif
 
@@ -56,19 +53,12 @@ using namespace std;
 
 namespace PolynomialRoots {
 
-  using std::abs;
-  using std::pow;
-  using std::frexp;
-
   #ifndef M_PI
   #define M_PI 3.14159265358979323846264338328
   #endif
 
   //static valueType const maxValue   = std::numeric_limits<valueType>::max();
   //static valueType const minValue   = std::numeric_limits<valueType>::min();
-  static valueType const epsilon    = std::numeric_limits<valueType>::epsilon();
-  static valueType const epsilon10  = 10*epsilon;
-  static valueType const epsilon100 = 100*epsilon;
 
   static valueType const RADFAC = M_PI / 180; // Degrees - to - radians conversion factor = pi / 180
   //static valueType const lb2    = log(2.0); // Dummy variable to avoid re - calculating this value in loop below
@@ -78,16 +68,17 @@ namespace PolynomialRoots {
   //============================================================================
   // Divides p by the quadratic x^2+u*x+v
   // placing the quotient in q and the remainder in a, b
+  template <typename Real>
   static
   void
   QuadraticSyntheticDivision(
     indexType       NN,
-    valueType       u,
-    valueType       v,
-    valueType const p[],
-    valueType       q[],
-    valueType     & a,
-    valueType     & b
+    Real            u,
+    Real            v,
+    Real const      p[],
+    Real            q[],
+    Real          & a,
+    Real          & b
   ) {
     q[0] = b = p[0];
     q[1] = a = p[1] - (b*u);
@@ -100,27 +91,29 @@ namespace PolynomialRoots {
   // K polynomial and new estimates of the quadratic coefficients.
   // calcSC - integer variable set here indicating how the calculations
   // are normalized to avoid overflow.
+  template <typename Real>
   static
   indexType
   calcSC(
     indexType       N,
-    valueType       a,
-    valueType       b,
-    valueType     & a1,
-    valueType     & a3,
-    valueType     & a7,
-    valueType     & c,
-    valueType     & d,
-    valueType     & e,
-    valueType     & f,
-    valueType     & g,
-    valueType     & h,
-    valueType const K[],
-    valueType       u,
-    valueType       v,
-    valueType       qk[]
+    Real            a,
+    Real            b,
+    Real          & a1,
+    Real          & a3,
+    Real          & a7,
+    Real          & c,
+    Real          & d,
+    Real          & e,
+    Real          & f,
+    Real          & g,
+    Real          & h,
+    Real const      K[],
+    Real            u,
+    Real            v,
+    Real            qk[]
   ) {
 
+    Real const epsilon100 = 100*machineEpsilon<Real>();
     indexType dumFlag = 3; // TYPE = 3 indicates the quadratic is almost a factor of K
 
     // Synthetic division of K by the quadratic 1, u, v
@@ -152,26 +145,28 @@ namespace PolynomialRoots {
 
   //============================================================================
   // Computes the next K polynomials using the scalars computed in calcSC_ak1
+  template <typename Real>
   static
   void
   nextK(
     indexType       N,
     indexType       tFlag,
-    valueType       a,
-    valueType       b,
-    valueType       a1,
-    valueType     & a3,
-    valueType     & a7,
-    valueType       K[],
-    valueType const qk[],
-    valueType const qp[]
+    Real            a,
+    Real            b,
+    Real            a1,
+    Real          & a3,
+    Real          & a7,
+    Real            K[],
+    Real const      qk[],
+    Real const      qp[]
   ) {
+    Real const epsilon10 = 10*machineEpsilon<Real>();
     if ( tFlag == 3 ) {
       // Use unscaled form of the recurrence
       K[1] = K[0] = 0;
       for ( indexType i = 2; i < N; ++i ) K[i] = qk[i-2];
     } else {
-      valueType temp = tFlag == 1 ? b : a;
+      Real temp = tFlag == 1 ? b : a;
       if ( abs(a1) > epsilon10 * abs(temp) ) {
         // Use scaled form of the recurrence
         a7 /= a1;
@@ -193,32 +188,33 @@ namespace PolynomialRoots {
   //============================================================================
   // Compute new estimates of the quadratic coefficients
   // using the scalars computed in calcSC
+  template <typename Real>
   static
   void
   newest(
     indexType       tFlag,
-    valueType     & uu,
-    valueType     & vv,
-    valueType       a,
-    valueType       a1,
-    valueType       a3,
-    valueType       a7,
-    valueType       b,
-    valueType       c,
-    valueType       d,
-    valueType       f,
-    valueType       g,
-    valueType       h,
-    valueType       u,
-    valueType       v,
-    valueType const K[],
+    Real          & uu,
+    Real          & vv,
+    Real            a,
+    Real            a1,
+    Real            a3,
+    Real            a7,
+    Real            b,
+    Real            c,
+    Real            d,
+    Real            f,
+    Real            g,
+    Real            h,
+    Real            u,
+    Real            v,
+    Real const      K[],
     indexType       N,
-    valueType const p[]
+    Real const      p[]
   ) {
 
     vv = uu = 0; // The quadratic is zeroed
     if ( tFlag != 3 ) {
-      valueType  a4, a5;
+      Real  a4, a5;
       if (tFlag != 2) {
         a4 = a + u * b + h * f;
         a5 = c + (u + v * f) * d;
@@ -227,16 +223,16 @@ namespace PolynomialRoots {
         a5 = (f + u) * c + v * d;
       }
       // Evaluate new quadratic coefficients
-      valueType b1 = -K[N - 1] / p[N];
-      valueType b2 = -(K[N - 2] + b1 * p[N - 1]) / p[N];
-      valueType c1 = v * b2 * a1;
-      valueType c2 = b1 * a7;
-      valueType c3 = b1 * b1 * a3;
-      valueType c4 = -(c2 + c3) + c1;
-      valueType temp = -c4 + a5 + b1 * a4;
+      Real b1 = -K[N - 1] / p[N];
+      Real b2 = -(K[N - 2] + b1 * p[N - 1]) / p[N];
+      Real c1 = v * b2 * a1;
+      Real c2 = b1 * a7;
+      Real c3 = b1 * b1 * a3;
+      Real c4 = -(c2 + c3) + c1;
+      Real temp = -c4 + a5 + b1 * a4;
       if ( temp != 0.0) {
         uu = -((u * (c3 + c2) + v * (b1 * a1 + b2 * a7)) / temp) + u;
-        vv = v * (1.0 + c4 / temp);
+        vv = v * (1 + c4 / temp);
       }
     }
   }
@@ -246,42 +242,45 @@ namespace PolynomialRoots {
   // sss - starting iterate
   // NZ - number of zeros found
   // iFlag - flag to indicate a pair of zeros near real axis
+  template <typename Real>
   static
   void
   RealIT(
     indexType     & iFlag,
     indexType     & NZ,
-    valueType     & sss,
+    Real          & sss,
     indexType       N,
-    valueType const p[],
+    Real const      p[],
     indexType       NN,
-    valueType       qp[],
-    valueType     & szr,
-    valueType     & szi,
-    valueType       K[],
-    valueType       qk[]
+    Real            qp[],
+    Real          & szr,
+    Real          & szi,
+    Real            K[],
+    Real            qk[]
   ) {
+    Real const epsilon   = machineEpsilon<Real>();
+    Real const epsilon10 = 10*epsilon;
     iFlag = NZ = 0;
-    valueType t=0, omp=0, s = sss;
+    Real t=0, omp=0, s = sss;
     for (indexType j=0;;) {
-      valueType pv = p[0]; // Evaluate p at s
+      Real pv = p[0]; // Evaluate p at s
       qp[0] = pv;
       for ( indexType i = 1; i < NN; ++i )
         qp[i] = pv = pv * s + p[i];
-      valueType mp = abs(pv);
+      Real mp = abs(pv);
       // Compute a rigorous bound on the error in evaluating p
-      valueType ms = abs(s);
-      valueType ee = 0.5 * abs(qp[0]);
+      Real ms = abs(s);
+      Real ee = abs(qp[0])/2;
       for ( indexType i = 1; i < NN; ++i ) ee = ee * ms + abs(qp[i]);
       // Iteration has converged sufficiently if the polynomial
       // value is less than 20 times this bound
-      if ( mp <= 20.0 * epsilon * (2*ee - mp) )
+      if ( mp <= 20 * epsilon * (2*ee - mp) )
         { NZ = 1; szr = s; szi = 0; break; }
 
       // Stop iteration after 10 steps
       if ( ++j > 10 ) break;
       if ( j >= 2 ) {
-        if ( (abs(t) <= 0.001 * abs(s-t)) && (mp > omp) ) {
+        if ( (abs(t) <= Real(0.001) * abs(s-t)) && (mp > omp) ) {
           // A cluster of zeros near the real axis has been encountered;
           // Return with iFlag set to initiate a quadratic iteration
           iFlag = 1;
@@ -292,13 +291,13 @@ namespace PolynomialRoots {
       // Return if the polynomial value has increased significantly
       omp = mp;
       // Compute t, the next polynomial and the new iterate
-      valueType kv = qk[0] = K[0];
+      Real kv = qk[0] = K[0];
       for ( indexType i = 1; i < N; ++i )
         qk[i] = kv = kv * s + K[i];
 
       if ( abs(kv) > abs(K[N-1]) * epsilon10 ) {
         // Use the scaled form of the recurrence if the value of K at s is non - zero
-        valueType tt = -(pv / kv);
+        Real tt = -(pv / kv);
         K[0] = qp[0];
         for ( indexType i = 1; i < N; ++i ) K[i] = tt * qk[i-1] + qp[i];
       } else { // Use unscaled form
@@ -315,58 +314,60 @@ namespace PolynomialRoots {
   //============================================================================
   // Variable - shift K - polynomial iteration for a quadratic
   // factor converges only if the zeros are equimodular or nearly so.
+  template <typename Real>
   static
   void
   QuadIT(
     indexType       N,
     indexType     & NZ,
-    valueType       uu,
-    valueType       vv,
-    valueType     & szr,
-    valueType     & szi,
-    valueType     & lzr,
-    valueType     & lzi,
-    valueType       qp[],
+    Real            uu,
+    Real            vv,
+    Real          & szr,
+    Real          & szi,
+    Real          & lzr,
+    Real          & lzi,
+    Real            qp[],
     indexType       NN,
-    valueType     & a,
-    valueType     & b,
-    valueType const p[],
-    valueType       qk[],
-    valueType     & a1,
-    valueType     & a3,
-    valueType     & a7,
-    valueType     & c,
-    valueType     & d,
-    valueType     & e,
-    valueType     & f,
-    valueType     & g,
-    valueType     & h,
-    valueType       K[]
+    Real          & a,
+    Real          & b,
+    Real const      p[],
+    Real            qk[],
+    Real          & a1,
+    Real          & a3,
+    Real          & a7,
+    Real          & c,
+    Real          & d,
+    Real          & e,
+    Real          & f,
+    Real          & g,
+    Real          & h,
+    Real            K[]
   ) {
 
+    Real const epsilon = machineEpsilon<Real>();
     NZ = 0; // Number of zeros found
     indexType	j = 0, tFlag;
-    valueType u = uu; // uu and vv are coefficients of the starting quadratic
-    valueType v = vv;
-    valueType relstp = 0; // initialize remove warning
-    valueType omp    = 0; // initialize remove warning
-    valueType ui, vi;
+    Real      u = uu; // uu and vv are coefficients of the starting quadratic
+    Real      v = vv;
+    Real      relstp = 0; // initialize remove warning
+    Real      omp    = 0; // initialize remove warning
+    Real      ui, vi;
     bool triedFlag = false;
     do {
-      Quadratic solve( 1.0, u, v );
+      QuadraticT<Real> solve( 1, u, v );
       solve.getRoot0(szr,szi);
       solve.getRoot1(lzr,lzi);
 
       // Return if roots of the quadratic are real and not close
       // to multiple or nearly equal and of opposite sign.
-      if ( abs(abs(szr) - abs(lzr)) > 0.01 * abs(lzr) ) break;
+      if ( abs(abs(szr) - abs(lzr)) > Real(0.01) * abs(lzr) ) break;
       // Evaluate polynomial by quadratic synthetic division
       QuadraticSyntheticDivision( NN, u, v, p, qp, a, b );
-      valueType mp = abs(a-(szr*b)) + abs(szi*b);
+      Real mp = abs(a-(szr*b)) + abs(szi*b);
       // Compute a rigorous bound on the rounding error in evaluating p
-      valueType zm = sqrt(abs(v));
-      valueType ee = 2 * abs(qp[0]);
-      valueType t  = -szr*b;
+      Real zm = sqrt(abs(v));
+      Real ee = 2 * abs(qp[0]);
+      Real t  = -szr*b;
       for ( indexType i = 1; i < N; ++i ) ee = ee * zm + abs(qp[i]);
       ee = ee * zm + abs(a+t);
       ee = (9*ee+2*abs(t)-7*(abs(a+t)+zm*abs(b)))*epsilon;
@@ -416,65 +417,62 @@ namespace PolynomialRoots {
   // L2 limit of fixed shift steps
   // NZ number of zeros found
   */
+  template <typename Real>
   static
   indexType
   FixedShift(
     indexType   L2,
-    valueType   sr,
-    valueType   v,
-    valueType   K[],
+    Real        sr,
+    Real        v,
+    Real        K[],
     indexType   N,
-    valueType   p[],
+    Real        p[],
     indexType   NN,
-    valueType   qp[],
-    valueType   u,
-    valueType & lzi,
-    valueType & lzr,
-    valueType & szi,
-    valueType & szr
+    Real        qp[],
+    Real        u,
+    Real      & lzi,
+    Real      & lzr,
+    Real      & szi,
+    Real      & szr,
+    Real        qk[],
+    Real        svk[]
   ) {
 
-    #ifdef _MSC_VER
-    valueType * qk  = (valueType*)alloca( 2*(N+1)*sizeof(valueType) );
-	  valueType * svk = qk+N+1;
-    #else
-    valueType	qk[N+1], svk[N+1];
-	  #endif
-
+    POLYNOMIAL_ROOTS_COUNT( JT_SHIFTS, 1 );
     indexType iFlag = 1;
     indexType NZ    = 0;
-    valueType betav = 0.25;
-    valueType betas = 0.25;
-    valueType oss   = sr;
-    valueType ovv   = v;
+    Real      betav = 0.25;
+    Real      betas = 0.25;
+    Real      oss   = sr;
+    Real      ovv   = v;
 
     // Evaluate polynomial by synthetic division
-    valueType a, b;
+    Real a, b;
     QuadraticSyntheticDivision(NN, u, v, p, qp, a, b);
-    valueType a1, a3, a7, c, d, e, f, g, h;
+    Real      a1, a3, a7, c, d, e, f, g, h;
     indexType tFlag =	calcSC(N, a, b, a1, a3, a7, c, d, e, f, g, h, K, u, v, qk);
 
-    valueType otv = 0; // initialize remove warning
-    valueType ots = 0; // initialize remove warning
+    Real otv = 0; // initialize remove warning
+    Real ots = 0; // initialize remove warning
     for ( indexType j = 0; j < L2; ++j ) {
       indexType fflag = 1;
       // Calculate next K polynomial and estimate v
       nextK( N, tFlag, a, b, a1, a3, a7, K, qk, qp );
       tFlag = calcSC(N, a, b, a1, a3, a7, c, d, e, f, g, h, K, u, v, qk);
-      valueType ui, vi;
+      Real ui, vi;
       newest(tFlag, ui, vi, a, a1, a3, a7, b, c, d, f, g, h, u, v, K, N, p);
-      valueType vv = vi;
+      Real vv = vi;
       // Estimate s
-      valueType ss = (K[N-1] != 0.0) ? -(p[N]/K[N-1]) : 0.0;
-      valueType ts = 1.0;
-      valueType tv = 1.0;
+      Real ss = (K[N-1] != 0) ? -(p[N]/K[N-1]) : 0;
+      Real ts = 1.0;
+      Real tv = 1.0;
       if ( (j != 0) && (tFlag != 3) ) {
         // Compute relative measures of convergence of s and v sequences
         tv = (vv != 0.0) ? abs((vv - ovv) / vv) : tv;
         ts = (ss != 0.0) ? abs((ss - oss) / ss) : ts;
         // If decreasing, multiply the two most recent convergence measures
-        valueType tvv = (tv < otv) ? tv * otv : 1;
-        valueType tss = (ts < ots) ? ts * ots : 1;
+        Real tvv = (tv < otv) ? tv * otv : 1;
+        Real tss = (ts < ots) ? ts * ots : 1;
         // Compare with convergence criteria
         bool vpass = tvv < betav;
         bool spass = tss < betas;
@@ -482,7 +480,7 @@ namespace PolynomialRoots {
           // At least one sequence has passed the convergence test.
           // Store variables before iterating
           for ( indexType i = 0; i < N; ++i ) svk[i] = K[i];
-          valueType s = ss;
+          Real s = ss;
           // Choose iteration according to the fastest converging sequence
           indexType stry = 0;
           indexType vtry = 0;
@@ -492,6 +490,7 @@ namespace PolynomialRoots {
                       ;
                         //Do nothing.Provides a quick "short circuit".
             } else {
+              POLYNOMIAL_ROOTS_COUNT( JT_QUADIT, 1 );
               QuadIT(N, NZ, ui, vi, szr, szi, lzr, lzi, qp, NN, a, b, p, qk, a1, a3, a7, c, d, e, f, g, h, K);
               if ( NZ > 0) return NZ;
               // Quadratic iteration has failed.Flag that it has been
@@ -503,6 +502,7 @@ namespace PolynomialRoots {
               else                  std::copy( svk, svk + N, K );
             }
             if ( iFlag != 0 ) {
+              POLYNOMIAL_ROOTS_COUNT( JT_REALIT, 1 );
               RealIT(iFlag, NZ, s, N, p, NN, qp, szr, szi, K, qk);
               if ( NZ > 0 ) return NZ;
               // Linear iteration has failed.Flag that it has been
@@ -538,26 +538,28 @@ namespace PolynomialRoots {
 
   //============================================================================
 
+  template <typename Real>
   static
   inline
-  valueType
-  evalPoly( valueType x, valueType const p[], indexType Degree ) {
-    valueType ff = p[0];
+  Real
+  evalPoly( Real x, Real const p[], indexType Degree ) {
+    Real ff = p[0];
     for ( indexType i = 1; i <= Degree; ++i ) ff = ff * x + p[i];
     return ff;
   }
 
   //============================================================================
 
+  template <typename Real>
   static
   inline
   void
   evalPoly(
-    valueType       x,
-    valueType const p[],
+    Real            x,
+    Real const      p[],
     indexType       Degree,
-    valueType     & f,
-    valueType     & df
+    Real          & f,
+    Real          & df
   ) {
     df = f = p[0];
     for ( indexType i = 1; i < Degree; ++i ) {
@@ -576,10 +578,11 @@ namespace PolynomialRoots {
   // interfering with the convergence criterion.
   // The factor is a power of the base.
   */
+  template <typename Real>
   static
   inline
   void
-  scalePoly( valueType p[], indexType N ) {
+  scalePoly( Real p[], indexType N ) {
     /*
     .. double ldexp(double x, int n)
     .. The ldexp() functions multiply x by 2 to the power n.
@@ -605,66 +608,62 @@ namespace PolynomialRoots {
 
   //============================================================================
 
-  // Compute lower bound on moduli of zeros
+  // Compute lower bound on moduli of zeros, pt[] is a work vector of size N+1
+  template <typename Real>
   static
   inline
-  valueType
-  lowerBoundZeroPoly( valueType p[], indexType N ) {
-
-    #ifdef _MSC_VER
-    valueType * pt  = (valueType*)alloca( (N+1)*sizeof(valueType) );
-    #else
-    valueType pt[N+1];
-	  #endif
+  Real
+  lowerBoundZeroPoly( Real const p[], indexType N, Real pt[] ) {
 
     for ( indexType i = 0; i < N; ++i ) pt[i] = abs(p[i]);
     pt[N] = -abs(p[N]);
 
     // Compute upper estimate of bound
-    valueType x = exp((log(-pt[N]) - log(pt[0]))/N);
+    Real x = exp((log(-pt[N]) - log(pt[0]))/N);
     if ( !isZero(pt[N-1]) ) { // If Newton step at the origin is better, use it
-      valueType xm = -pt[N]/pt[N-1];
+      Real xm = -pt[N]/pt[N-1];
       if ( xm < x ) x = xm;
     }
     // Chop the interval(0, x) until f <= 0
-    valueType xm = x;
-    while ( evalPoly( xm, pt, N ) > 0 ) { x = xm; xm = 0.1 * x; }
+    Real xm = x;
+    while ( evalPoly( xm, pt, N ) > 0 ) { x = xm; xm = Real(0.1) * x; }
 
     // Do Newton iteration until x converges to two decimal places
-    valueType dx;
+    Real dx;
     do {
-      valueType f, df;
+      Real f, df;
       evalPoly( x, pt, N, f, df );
       dx = f / df;
       x -= dx;
-    } while ( abs(dx) > abs(x)*0.005 );
+    } while ( abs(dx) > abs(x)*Real(0.005) );
     return x;
   }
 
   //============================================================================
 
+  template <typename Real>
   static
   inline
   void
   roots3(
-    valueType const p[4],
+    Real const      p[4],
     indexType       Degree,
-    valueType       zeror[],
-    valueType       zeroi[]
+    Real            zeror[],
+    Real            zeroi[]
   ) {
     if ( Degree == 1 ) {
       zeror[0] = -(p[1]/p[0]);
       zeroi[0] = 0;
     } else if ( Degree == 2 ) {
-      Quadratic solve( p[0], p[1], p[2] );
+      QuadraticT<Real> solve( p[0], p[1], p[2] );
       switch ( solve.numRoots() ) {
         case 2: solve.getRoot1( zeror[1], zeroi[1] );
         case 1: solve.getRoot0( zeror[0], zeroi[0] );
       }
     } else if ( Degree == 3 ) {
-      Cubic solve( p[0], p[1], p[2], p[3] );
+      CubicT<Real> solve( p[0], p[1], p[2], p[3] );
       switch ( solve.numRoots() ) {
-        case 3: solve.getRoot1( zeror[2], zeroi[2] );
+        case 3: solve.getRoot2( zeror[2], zeroi[2] );
         case 2: solve.getRoot1( zeror[1], zeroi[1] );
         case 1: solve.getRoot0( zeror[0], zeroi[0] );
       }
@@ -672,36 +671,38 @@ namespace PolynomialRoots {
   }
 
   //============================================================================
+  template <typename Real>
   int
   roots(
-    valueType const op[],
-    indexType       Degree,
-    valueType       zeror[],
-    valueType       zeroi[]
+    JenkinsTraubWorkspaceT<Real> & work,
+    Real const                     op[],
+    indexType                      Degree,
+    Real                           zeror[],
+    Real                           zeroi[]
   ) {
 
+    Real const epsilon10 = 10*machineEpsilon<Real>();
     if ( Degree < 1 ) return -1;
 
     // Do a quick check to see if leading coefficient is 0
     // The leading coefficient is zero. No further action taken. Program terminated
     if ( isZero(op[0]) ) return -2;
 
-    #ifdef _MSC_VER
-    valueType * ptr = (valueType*)alloca( 4*(Degree+1)*sizeof(valueType) );
-    valueType * K    = ptr; ptr += Degree+1;
-    valueType * p    = ptr; ptr += Degree+1;
-    valueType * qp   = ptr; ptr += Degree+1;
-    valueType * temp = ptr; ptr += Degree+1;
-    #else
-    valueType K[Degree+1];
-    valueType p[Degree+1];
-    valueType qp[Degree+1];
-    valueType temp[Degree+1];
-    #endif
+    if ( Degree > work.getMaxDegree() ) return -3;
+
+    POLYNOMIAL_ROOTS_COUNT( JT_SOLVES, 1 );
+
+    Real * K    = work.getBuffer(0);
+    Real * p    = work.getBuffer(1);
+    Real * qp   = work.getBuffer(2);
+    Real * temp = work.getBuffer(3);
+    Real * qk   = work.getBuffer(4);
+    Real * svk  = work.getBuffer(5);
+    Real * pt   = work.getBuffer(6);
 
     int N = Degree;
-    valueType xx = sqrt(0.5); //= 0.70710678
-    valueType yy = -xx;
+    Real xx = sqrt(Real(0.5)); //= 0.70710678
+    Real yy = -xx;
 
     // Remove zeros at the origin, if any
     for ( indexType j = 0; isZero(op[N]); ++j, --N ) zeror[j] = zeroi[j] = 0.0;
@@ -716,15 +717,15 @@ namespace PolynomialRoots {
       scalePoly( p, N );
 
       // Compute lower bound on moduli of zeros
-      valueType bnd = lowerBoundZeroPoly( p, N );
+      Real bnd = lowerBoundZeroPoly( p, N, pt );
 
       // Compute the derivative as the initial K polynomial and
       // do 5 steps with no shift
       for ( indexType i = 1; i < N; ++i ) K[i] = ((N-i) * p[i]) / N;
       K[0] = p[0];
       indexType NM1 = N-1;
-      valueType aa = p[N];
-      valueType bb = p[NM1];
+      Real      aa = p[N];
+      Real      bb = p[NM1];
       bool zerok = isZero(K[NM1]);
       for ( indexType iter = 0; iter < 5; ++iter ) {
         if ( zerok ) { // Use unscaled form of recurrence
@@ -732,7 +733,7 @@ namespace PolynomialRoots {
           K[0] = 0;
           zerok = isZero(K[NM1]);
         } else { // Used scaled form of recurrence if value of K at 0 is nonzero
-          valueType t = -aa / K[NM1];
+          Real t = -aa / K[NM1];
           for ( indexType i = 0; i < NM1; ++i ) {
             indexType j = NM1-i;
             K[j] = t * K[j-1] + p[j];
@@ -751,14 +752,14 @@ namespace PolynomialRoots {
         // Quadratic corresponds to a double shift to a non-real point and its
         // complex conjugate. The point has modulus BND and amplitude rotated
         // by 94 degrees from the previous shift.
-        valueType tmp = -(sinr * yy) + cosr * xx;
-        yy = sinr * xx + cosr * yy;
+        Real tmp = -(Real(sinr) * yy) + Real(cosr) * xx;
+        yy = Real(sinr) * xx + Real(cosr) * yy;
         xx = tmp;
-        valueType sr = bnd * xx;
-        valueType u = -2*sr;
+        Real sr = bnd * xx;
+        Real u = -2*sr;
         // Second stage calculation, fixed quadratic
-        valueType lzi, lzr, szi, szr;
-        indexType NZ = FixedShift( 20*(iter+1), sr, bnd, K, N, p, N+1, qp, u, lzi, lzr, szi, szr);
+        Real      lzi, lzr, szi, szr;
+        indexType NZ = FixedShift( 20*(iter+1), sr, bnd, K, N, p, N+1, qp, u, lzi, lzr, szi, szr, qk, svk );
         ok = NZ != 0;
         if ( ok ) {
           //The second stage jumps directly to one of the third stage iterations and
@@ -775,12 +776,34 @@ namespace PolynomialRoots {
           }
         } else {
           // If the iteration is unsuccessful, another quadratic is chosen after restoring K
+          POLYNOMIAL_ROOTS_COUNT( JT_SHIFT_RETRIES, 1 );
           std::copy( temp, temp+N, K );
         }
       }
       // Return with failure if no convergence with 20 shifts
-      if ( !ok ) return -2;
+      if ( !ok ) { POLYNOMIAL_ROOTS_COUNT( JT_FAILURES, 1 ); return -2; }
     }
     return 0;
   }
+
+  //============================================================================
+  template <typename Real>
+  int
+  roots(
+    Real const      op[],
+    indexType       Degree,
+    Real            zeror[],
+    Real            zeroi[]
+  ) {
+    JenkinsTraubWorkspaceT<Real> work( Degree );
+    return roots( work, op, Degree, zeror, zeroi );
+  }
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                             \
+  template class JenkinsTraubWorkspaceT<Real>;                           \
+  template int roots( Real const [], indexType, Real [], Real [] );      \
+  template int roots( JenkinsTraubWorkspaceT<Real> &, Real const [],     \
+                      indexType, Real [], Real [] );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
 }
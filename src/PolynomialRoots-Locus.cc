@@ -0,0 +1,351 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include <algorithm>
+#include <vector>
+
+namespace PolynomialRoots {
+
+  /*\
+   *  Continuation of the roots of p(x) + k*q(x) along the gain k:
+   *  predictor along the tangent dz/dk, Newton corrector, adaptive step.
+  \*/
+
+  // maximum number of Newton corrections of a predictor-corrector step
+  static indexType const maxCorrections = 5;
+
+  // smallest step, as a fraction of the distance between two gains
+  static indexType const minStepFraction = 64;
+
+  // p(z) and p'(z) by Horner, z = x + I*y, split real and imaginary parts
+  template <typename Real>
+  static
+  inline
+  void
+  hornerDC(
+    Real const op[],
+    indexType  Degree,
+    Real       x,
+    Real       y,
+    Real     & pr,
+    Real     & pi,
+    Real     & dr,
+    Real     & di
+  ) {
+    pr = op[0]; pi = dr = di = 0;
+    for ( indexType i = 1; i <= Degree; ++i ) {
+      Real t = dr*x - di*y + pr;
+      di = dr*y + di*x + pi;
+      dr = t;
+      t  = pr*x - pi*y + op[i];
+      pi = pr*y + pi*x;
+      pr = t;
+    }
+  }
+
+  template <typename Real>
+  static
+  inline
+  void
+  hornerC(
+    Real const op[],
+    indexType  Degree,
+    Real       x,
+    Real       y,
+    Real     & pr,
+    Real     & pi
+  ) {
+    pr = op[0]; pi = 0;
+    for ( indexType i = 1; i <= Degree; ++i ) {
+      Real t = pr*x - pi*y + op[i];
+      pi = pr*y + pi*x;
+      pr = t;
+    }
+  }
+
+  /*\
+   *  State of the tracking of the n roots of p(x) + k*q(x), the
+   *  polynomials are padded with leading zeros to the same degree n.
+  \*/
+
+  template <typename Real>
+  struct LocusTracker {
+    indexType         n;
+    std::vector<Real> p, q, c;     // p, q and p + k*q
+    std::vector<Real> zr, zi;      // roots at the current gain
+    std::vector<Real> dzr, dzi;    // dz/dk at the roots
+    std::vector<Real> xr, xi;      // predicted and corrected roots
+    std::vector<Real> fr, fi;      // roots of a full solve
+    std::vector<Real> dpr, dpi;    // p'(x) + k*q'(x) at the corrected roots
+    std::vector<char> used;
+    JenkinsTraubWorkspaceT<Real> work;
+
+    LocusTracker(
+      Real const _p[], indexType degP,
+      Real const _q[], indexType degQ
+    )
+    : n(std::max(degP,degQ))
+    , p(n+1,0), q(n+1,0), c(n+1)
+    , zr(n), zi(n), dzr(n), dzi(n), xr(n), xi(n), fr(n), fi(n)
+    , dpr(n), dpi(n), used(n)
+    , work(n)
+    {
+      std::copy( _p, _p+degP+1, p.begin()+(n-degP) );
+      std::copy( _q, _q+degQ+1, q.begin()+(n-degQ) );
+    }
+
+    void
+    combine( Real k ) {
+      for ( indexType i = 0; i <= n; ++i ) c[i] = p[i] + k*q[i];
+    }
+
+    // dz/dk = -q(z)/(p'(z)+k*q'(z)), the derivatives of the last corrections
+    void
+    tangents() {
+      for ( indexType i = 0; i < n; ++i ) {
+        Real qr, qi;
+        hornerC( &q.front(), n, zr[i], zi[i], qr, qi );
+        Real den = dpr[i]*dpr[i] + dpi[i]*dpi[i];
+        if ( den > 0 ) {
+          dzr[i] = -(qr*dpr[i] + qi*dpi[i])/den;
+          dzi[i] = -(qi*dpr[i] - qr*dpi[i])/den;
+        } else {
+          dzr[i] = dzi[i] = 0;
+        }
+      }
+    }
+
+    // Newton corrections of the root i on c = p + k*q from (xr[i],xi[i])
+    bool
+    correct( indexType i ) {
+      Real const machepsi = machineEpsilon<Real>();
+      Real x = xr[i], y = xi[i], ad0 = 0;
+      for ( indexType it = 0; it < maxCorrections; ++it ) {
+        Real pr, pi, dr, di;
+        hornerDC( &c.front(), n, x, y, pr, pi, dr, di );
+        dpr[i] = dr; dpi[i] = di;
+        if ( pr == 0 && pi == 0 ) { xr[i] = x; xi[i] = y; return true; }
+        Real den = dr*dr + di*di;
+        if ( !(den > 0) ) return false;
+        Real ddr = (pr*dr + pi*di)/den;
+        Real ddi = (pi*dr - pr*di)/den;
+        x -= ddr;
+        y -= ddi;
+        Real ad = sqrt( ddr*ddr + ddi*ddi );
+        Real ax = sqrt( x*x + y*y );
+        bool converged = ad <= 4 * machepsi * ax;
+        if ( !converged && ad0 > 0 ) {
+          Real r = ad/ad0; // contraction of the corrections
+          if ( r > Real(0.5) ) {
+            // no contraction, accepted only at the level of the rounding
+            if ( ad > 100 * machepsi * ax ) return false;
+            converged = true;
+          } else {
+            converged = r*r*ad <= machepsi * ax;
+          }
+        }
+        if ( converged ) { xr[i] = x; xi[i] = y; return true; }
+        ad0 = ad;
+      }
+      return false;
+    }
+
+    /*\
+     *  One predictor-corrector step of length h from the gain k-h to k,
+     *  c = p + k*q. Return 0 if accepted (roots in xr, xi), 1 if rejected,
+     *  2 if rejected because two roots of a real or conjugate pair collide.
+    \*/
+    int
+    step( Real h ) {
+      for ( indexType i = 0; i < n; ++i ) {
+        xr[i] = zr[i] + h*dzr[i];
+        xi[i] = zi[i] + h*dzi[i];
+      }
+      // distance of each prediction from the nearest other one
+      std::vector<Real> & sep = fr;
+      for ( indexType i = 0; i < n; ++i ) sep[i] = -1;
+      for ( indexType i = 0; i < n; ++i ) {
+        for ( indexType j = i+1; j < n; ++j ) {
+          Real dx = xr[i]-xr[j], dy = xi[i]-xi[j];
+          Real d  = dx*dx + dy*dy;
+          if ( sep[i] < 0 || d < sep[i] ) sep[i] = d;
+          if ( sep[j] < 0 || d < sep[j] ) sep[j] = d;
+        }
+      }
+      for ( indexType i = 0; i < n; ++i ) {
+        Real pxr = xr[i], pxi = xi[i];
+        bool ok = correct( i );
+        if ( ok && sep[i] >= 0 ) {
+          // the correction must not move the root towards another one
+          Real dx = xr[i]-pxr, dy = xi[i]-pxi;
+          ok = 9*(dx*dx+dy*dy) <= sep[i];
+        }
+        if ( !ok ) return collision( i, h ) ? 2 : 1;
+      }
+      return 0;
+    }
+
+    // true if root i approaches its real or conjugate partner within the step
+    bool
+    collision( indexType i, Real h ) const {
+      indexType j  = n;
+      Real      dj = 0;
+      for ( indexType l = 0; l < n; ++l ) {
+        if ( l == i ) continue;
+        Real dx = zr[i]-zr[l], dy = zi[i]-zi[l];
+        Real d  = dx*dx + dy*dy;
+        if ( j == n || d < dj ) { j = l; dj = d; }
+      }
+      if ( j == n ) return false;
+      bool pair = ( zi[i] == 0 && zi[j] == 0 ) ||
+                  ( zr[i] == zr[j] && zi[i] == -zi[j] );
+      if ( !pair ) return false;
+      Real vx = h*(dzr[i]-dzr[j]), vy = h*(dzi[i]-dzi[j]);
+      return 4*(vx*vx+vy*vy) >= dj; // closes at least half of the gap
+    }
+
+    /*\
+     *  Track the roots from the gain k0 to k1 with steps of adaptive
+     *  length, h is the length of the last accepted step (0 if none).
+     *  Return false if the tracking fails.
+    \*/
+    bool
+    track( Real k0, Real k1, Real & h ) {
+      Real span = k1-k0;
+      if ( span == 0 ) return true;
+      Real hmin = abs(span)/minStepFraction;
+      Real hh   = ( h != 0 && abs(h) < abs(span) ) ? abs(h) : abs(span);
+      if ( span < 0 ) hh = -hh;
+      Real k = k0;
+      while ( k != k1 ) {
+        bool last = abs(hh) >= abs(k1-k);
+        Real kn   = last ? k1 : k+hh;
+        combine( kn );
+        int res = step( kn-k );
+        if ( res == 0 ) {
+          POLYNOMIAL_ROOTS_COUNT( LOCUS_STEPS, 1 );
+          std::swap( zr, xr );
+          std::swap( zi, xi );
+          tangents();
+          k  = kn;
+          hh = 2*hh;
+        } else if ( res == 2 ) {
+          POLYNOMIAL_ROOTS_COUNT( LOCUS_COLLISIONS, 1 );
+          return false;
+        } else {
+          POLYNOMIAL_ROOTS_COUNT( LOCUS_REJECTED, 1 );
+          hh = hh/2;
+          if ( abs(hh) < hmin ) return false;
+        }
+      }
+      h = hh;
+      return true;
+    }
+
+    /*\
+     *  Roots of p + k*q from scratch. If matchRoots the roots are
+     *  reordered so that the i-th one is the nearest to the current i-th
+     *  root, the loci stay continuous across a full solve.
+    \*/
+    indexType
+    solve( Real k, bool matchRoots ) {
+      POLYNOMIAL_ROOTS_COUNT( LOCUS_FULL_SOLVES, 1 );
+      combine( k );
+      indexType res = solvePolynomial( n, &c.front(), &fr.front(), &fi.front(), work );
+      if ( res != 0 ) return res;
+      if ( matchRoots ) {
+        std::fill( used.begin(), used.end(), 0 );
+        for ( indexType i = 0; i < n; ++i ) {
+          indexType jb = n;
+          Real      db = 0;
+          for ( indexType j = 0; j < n; ++j ) {
+            if ( used[j] ) continue;
+            Real dx = fr[j]-zr[i], dy = fi[j]-zi[i];
+            Real d  = dx*dx + dy*dy;
+            if ( jb == n || d < db ) { jb = j; db = d; }
+          }
+          used[jb] = 1;
+          xr[i] = fr[jb];
+          xi[i] = fi[jb];
+        }
+        std::swap( zr, xr );
+        std::swap( zi, xi );
+      } else {
+        std::copy( fr.begin(), fr.end(), zr.begin() );
+        std::copy( fi.begin(), fi.end(), zi.begin() );
+      }
+      // derivatives for the tangents
+      for ( indexType i = 0; i < n; ++i ) {
+        Real pr, pi;
+        hornerDC( &c.front(), n, zr[i], zi[i], pr, pi, dpr[i], dpi[i] );
+      }
+      tangents();
+      return 0;
+    }
+  };
+
+  template <typename Real>
+  indexType
+  rootLocus(
+    Real const p[],
+    indexType  degP,
+    Real const q[],
+    indexType  degQ,
+    Real const k[],
+    indexType  nk,
+    Real       zeror[],
+    Real       zeroi[],
+    indexType  info[]
+  ) {
+    LocusTracker<Real> t( p, degP, q, degQ );
+    indexType const n     = t.n;
+    indexType       nfull = 0;
+    bool            valid = false; // the roots at k[j-1] are known
+    Real            h     = 0;
+    for ( indexType j = 0; j < nk; ++j ) {
+      if ( valid && t.track( k[j-1], k[j], h ) ) {
+        info[j] = 0;
+      } else {
+        ++nfull;
+        h       = 0;
+        info[j] = t.solve( k[j], valid );
+        valid   = info[j] == 0;
+        if ( valid ) info[j] = 1;
+      }
+      for ( indexType i = 0; i < n; ++i ) {
+        zeror[j*n+i] = valid ? t.zr[i] : 0;
+        zeroi[j*n+i] = valid ? t.zi[i] : 0;
+      }
+    }
+    return nfull;
+  }
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                           \
+  template indexType rootLocus( Real const [], indexType,              \
+                                Real const [], indexType,              \
+                                Real const [], indexType,              \
+                                Real [], Real [], indexType [] );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
+}
+
+// EOF: PolynomialRoots-Locus.cc
@@ -0,0 +1,186 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PolynomialRoots {
+
+  // number of polynomials assigned to a thread at a time
+  static indexType const chunkSize = 64;
+
+  /*\
+   *  Range [begin,end) of the chunks owned by a thread. The owner takes
+   *  chunks from the front, the other threads steal from the back.
+  \*/
+
+  struct ChunkQueue {
+    std::mutex mtx;
+    indexType  begin;
+    indexType  end;
+    ChunkQueue() : begin(0), end(0) {}
+  };
+
+  static
+  bool
+  popChunk( ChunkQueue & q, indexType & chunk ) {
+    std::lock_guard<std::mutex> lock( q.mtx );
+    if ( q.begin >= q.end ) return false;
+    chunk = q.begin++;
+    return true;
+  }
+
+  // move the upper half of the chunks of `victim` to the (empty) queue `q`
+  static
+  bool
+  stealChunks( ChunkQueue & victim, ChunkQueue & q ) {
+    indexType b, e;
+    {
+      std::lock_guard<std::mutex> lock( victim.mtx );
+      if ( victim.begin >= victim.end ) return false;
+      e = victim.end;
+      b = victim.begin + (victim.end-victim.begin)/2;
+      victim.end = b;
+    }
+    std::lock_guard<std::mutex> lock( q.mtx );
+    q.begin = b;
+    q.end   = e;
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  //! arguments of `solveBatchParallel` shared by the threads
+  template <typename Real>
+  struct ParallelBatch {
+    indexType               n;
+    indexType const *       degree;
+    indexType const *       offset;
+    Real const *            coeffs;
+    Real *                  zeror;
+    Real *                  zeroi;
+    indexType *             info;
+    indexType               maxDegree;
+    std::vector<ChunkQueue> queues;
+    ParallelBatch( indexType nthreads ) : queues(nthreads) {}
+  };
+
+  template <typename Real>
+  static
+  void
+  parallelBatchWorker(
+    indexType             id,
+    ParallelBatch<Real> & batch,
+    ParallelBatchStats  & stats
+  ) {
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start = clock::now();
+
+    JenkinsTraubWorkspaceT<Real> work( batch.maxDegree );
+    indexType nthreads = indexType(batch.queues.size());
+    stats.nsolved = stats.nstolen = 0;
+    for (;;) {
+      indexType chunk;
+      if ( !popChunk( batch.queues[id], chunk ) ) {
+        // own queue is empty, steal from the other threads
+        bool stolen = false;
+        for ( indexType k = 1; k < nthreads && !stolen; ++k )
+          stolen = stealChunks( batch.queues[(id+k)%nthreads], batch.queues[id] );
+        if ( !stolen ) break; // all the queues are empty
+        ++stats.nstolen;
+        continue;
+      }
+      indexType i1 = std::min( (chunk+1)*chunkSize, batch.n );
+      for ( indexType i = chunk*chunkSize; i < i1; ++i ) {
+        indexType j = batch.offset[i];
+        batch.info[i] = solvePolynomial(
+          batch.degree[i], batch.coeffs+j,
+          batch.zeror+j-i, batch.zeroi+j-i, work
+        );
+        ++stats.nsolved;
+      }
+    }
+    stats.seconds = std::chrono::duration<double>( clock::now() - start ).count();
+  }
+
+  template <typename Real>
+  indexType
+  solveBatchParallel(
+    indexType          n,
+    indexType const    degree[],
+    indexType const    offset[],
+    Real const         coeffs[],
+    Real               zeror[],
+    Real               zeroi[],
+    indexType          info[],
+    indexType          nthreads,
+    ParallelBatchStats stats[]
+  ) {
+    if ( nthreads <= 0 ) nthreads = indexType(std::thread::hardware_concurrency());
+    indexType nchunks = (n+chunkSize-1)/chunkSize;
+    nthreads = std::max( indexType(1), std::min( nthreads, nchunks ) );
+
+    ParallelBatch<Real> batch( nthreads );
+    batch.n         = n;
+    batch.degree    = degree;
+    batch.offset    = offset;
+    batch.coeffs    = coeffs;
+    batch.zeror     = zeror;
+    batch.zeroi     = zeroi;
+    batch.info      = info;
+    batch.maxDegree = 0;
+    for ( indexType i = 0; i < n; ++i )
+      batch.maxDegree = std::max( batch.maxDegree, degree[i] );
+
+    // initial partition: contiguous ranges of chunks of the same size
+    for ( indexType t = 0; t < nthreads; ++t ) {
+      batch.queues[t].begin = (t*nchunks)/nthreads;
+      batch.queues[t].end   = ((t+1)*nchunks)/nthreads;
+    }
+
+    std::vector<ParallelBatchStats> st( nthreads );
+    std::vector<std::thread>        threads;
+    for ( indexType t = 1; t < nthreads; ++t )
+      threads.push_back( std::thread( parallelBatchWorker<Real>, t,
+                                      std::ref(batch), std::ref(st[t]) ) );
+    parallelBatchWorker( 0, batch, st[0] ); // the calling thread works too
+    for ( std::size_t t = 0; t < threads.size(); ++t ) threads[t].join();
+
+    if ( stats != NULL ) std::copy( st.begin(), st.end(), stats );
+    return nthreads;
+  }
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                             \
+  template indexType solveBatchParallel( indexType, indexType const [],  \
+                                         indexType const [],             \
+                                         Real const [], Real [], Real [], \
+                                         indexType [], indexType,        \
+                                         ParallelBatchStats [] );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
+}
+
+// EOF: PolynomialRoots-Parallel.cc
@@ -0,0 +1,183 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+
+#ifdef POLYNOMIAL_ROOTS_STATS
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace PolynomialRoots {
+
+  static char const * counterNames[SolverStats::numCounters] = {
+    "cubic solves",
+    "cubic special cases",
+    "cubic triple roots",
+    "cubic shifted",
+    "cubic Newton iterations",
+    "cubic bisections",
+    "cubic bisection iterations",
+    "cubic warm starts",
+    "cubic warm start fallbacks",
+    "cubic table guesses",
+    "cubic table fallbacks",
+    "cubic closed forms",
+    "cubic closed form fallbacks",
+    "quartic solves",
+    "quartic as cubic",
+    "quartic biquadratic",
+    "quartic real root",
+    "quartic hexic",
+    "quartic equal real parts",
+    "quartic real only exit",
+    "quartic Newton iterations",
+    "quartic bisections",
+    "quartic bisection iterations",
+    "quartic warm starts",
+    "quartic warm start fallbacks",
+    "quartic closed forms",
+    "quartic closed form fallbacks",
+    "JT solves",
+    "JT fixed shifts",
+    "JT shift retries",
+    "JT quadratic iterations",
+    "JT real iterations",
+    "JT failures",
+    "locus steps",
+    "locus rejected steps",
+    "locus collisions",
+    "locus full solves",
+    "Sturm counts",
+    "Sturm rejections"
+  };
+
+  char const *
+  SolverStats::name( Counter i ) {
+    return i >= 0 && i < numCounters ? counterNames[i] : "unknown";
+  }
+
+  void
+  SolverStats::info( std::ostream & s ) const {
+    for ( int i = 0; i < numCounters; ++i )
+      if ( count[i] > 0 )
+        s << counterNames[i] << " = " << count[i] << '\n';
+  }
+
+  #ifdef POLYNOMIAL_ROOTS_STATS
+
+  /*\
+   *  Counters of a thread. Only the owner thread writes its counters, so a
+   *  relaxed load+store is enough, the atomics make the reads of
+   *  `getGlobalStats` from other threads well defined. The counters of a
+   *  terminated thread are added to `retired`.
+  \*/
+
+  struct ThreadCounters {
+    std::atomic<unsigned long long> count[SolverStats::numCounters];
+    ThreadCounters();
+    ~ThreadCounters();
+  };
+
+  struct StatsRegistry {
+    std::mutex                    mtx;
+    std::vector<ThreadCounters *> threads;
+    SolverStats                   retired;
+  };
+
+  static
+  StatsRegistry &
+  statsRegistry() {
+    static StatsRegistry registry;
+    return registry;
+  }
+
+  ThreadCounters::ThreadCounters() {
+    for ( int i = 0; i < SolverStats::numCounters; ++i ) count[i] = 0;
+    StatsRegistry & r = statsRegistry();
+    std::lock_guard<std::mutex> lock( r.mtx );
+    r.threads.push_back( this );
+  }
+
+  ThreadCounters::~ThreadCounters() {
+    StatsRegistry & r = statsRegistry();
+    std::lock_guard<std::mutex> lock( r.mtx );
+    for ( int i = 0; i < SolverStats::numCounters; ++i ) r.retired.count[i] += count[i];
+    for ( std::size_t k = 0; k < r.threads.size(); ++k )
+      if ( r.threads[k] == this ) { r.threads.erase( r.threads.begin()+k ); break; }
+  }
+
+  static thread_local ThreadCounters threadCounters;
+
+  static
+  void
+  addCounters( SolverStats & s, ThreadCounters const & t ) {
+    for ( int i = 0; i < SolverStats::numCounters; ++i )
+      s.count[i] += t.count[i].load( std::memory_order_relaxed );
+  }
+
+  void
+  countEvent( int c, unsigned long long n ) {
+    std::atomic<unsigned long long> & a = threadCounters.count[c];
+    a.store( a.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+  }
+
+  bool statsEnabled() { return true; }
+
+  SolverStats
+  getThreadStats() {
+    SolverStats s;
+    addCounters( s, threadCounters );
+    return s;
+  }
+
+  SolverStats
+  getGlobalStats() {
+    StatsRegistry & r = statsRegistry();
+    std::lock_guard<std::mutex> lock( r.mtx );
+    SolverStats s = r.retired;
+    for ( std::size_t k = 0; k < r.threads.size(); ++k ) addCounters( s, *r.threads[k] );
+    return s;
+  }
+
+  void
+  resetStats() {
+    StatsRegistry & r = statsRegistry();
+    std::lock_guard<std::mutex> lock( r.mtx );
+    r.retired.reset();
+    for ( std::size_t k = 0; k < r.threads.size(); ++k )
+      for ( int i = 0; i < SolverStats::numCounters; ++i )
+        r.threads[k]->count[i].store( 0, std::memory_order_relaxed );
+  }
+
+  #else
+
+  void countEvent( int, unsigned long long ) {}
+  bool statsEnabled() { return false; }
+  SolverStats getThreadStats() { return SolverStats(); }
+  SolverStats getGlobalStats() { return SolverStats(); }
+  void resetStats() {}
+
+  #endif
+
+}
+
+// EOF: PolynomialRoots-Stats.cc
@@ -0,0 +1,319 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include <algorithm>
+#include <vector>
+
+namespace PolynomialRoots {
+
+  /*\
+   *  Sturm sequences: the remainders of the polynomial division, the sign
+   *  changes at a point and the rejection of the intervals without roots
+   *  by a bound of |p'|.
+  \*/
+
+  /*\
+   *  True if |p(a)| + |p(b)| is above (b-a) times the bound of |p'| on
+   *  [a,b] given by the absolute values of the coefficients at
+   *  max(|a|,|b|), plus the rounding of p(a) and p(b): a root x in [a,b]
+   *  would give |p(a)| <= (x-a)*max|p'| and |p(b)| <= (b-x)*max|p'|.
+  \*/
+
+  template <typename Real>
+  static
+  inline
+  bool
+  noRootsByBound( Real const p[], indexType degree, Real a, Real b ) {
+    Real pa = evalPoly( p, degree, a );
+    Real pb = evalPoly( p, degree, b );
+    if ( pa == 0 || pb == 0 || (pa < 0) != (pb < 0) ) return false;
+    Real m     = std::max( abs(a), abs(b) );
+    Real dp    = 0;
+    Real bound = abs(p[0]);
+    for ( indexType i = 1; i <= degree; ++i ) {
+      dp    = dp * m + Real(degree-i+1) * abs(p[i-1]);
+      bound = bound * m + abs(p[i]);
+    }
+    return abs(pa) + abs(pb) > (b-a) * dp + 4 * degree * machineEpsilon<Real>() * bound;
+  }
+
+  // divide p[0..n] by its largest coefficient in absolute value (keeps the signs)
+  template <typename Real>
+  static
+  inline
+  void
+  scaleToUnit( Real p[], indexType n ) {
+    Real pmax = 0;
+    for ( indexType i = 0; i <= n; ++i ) pmax = std::max( pmax, abs(p[i]) );
+    if ( pmax > 0 ) for ( indexType i = 0; i <= n; ++i ) p[i] /= pmax;
+  }
+
+  /*\
+   *  Sturm sequence of op[0..Degree] (leading coefficient first): the
+   *  polynomials are stored one after the other in seq[], which has room
+   *  for (Degree+1)*(Degree+2)/2 coefficients, and their degrees in deg[],
+   *  with room for Degree+1 values. work[] has 2*(Degree+1) entries.
+   *  The polynomials after op are scaled by scaleToUnit.
+   *  The remainder of u by v is computed with the sum e[] of the absolute
+   *  values of the terms of each coefficient, a coefficient below the
+   *  rounding of its terms is zero. Return the number of polynomials.
+  \*/
+
+  template <typename Real>
+  static
+  indexType
+  sturmSequence(
+    Real const op[],
+    indexType  Degree,
+    Real       seq[],
+    indexType  deg[],
+    Real       work[]
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    indexType i0 = 0;
+    while ( i0 < Degree && isZero(op[i0]) ) ++i0; // drop the leading zeros
+    indexType n = Degree-i0;
+
+    // p0 = op (not scaled, so that it vanishes exactly where op does), p1 = op'
+    Real * u = seq;
+    std::copy( op+i0, op+Degree+1, u );
+    deg[0] = n;
+    if ( n == 0 ) return 1;
+    Real * v = u+n+1;
+    for ( indexType i = 0; i < n; ++i ) v[i] = Real(n-i) * u[i];
+    scaleToUnit( v, n-1 );
+    deg[1] = n-1;
+
+    indexType np = 2;
+    Real * w = work;
+    Real * e = work+n+1;
+    while ( deg[np-1] > 0 ) {
+      indexType m = deg[np-2];
+      indexType d = deg[np-1];
+      for ( indexType i = 0; i <= m; ++i ) { w[i] = u[i]; e[i] = abs(u[i]); }
+      for ( indexType j = 0; j <= m-d; ++j ) {
+        Real q = w[j]/v[0];
+        for ( indexType i = 1; i <= d; ++i ) {
+          Real t = q*v[i];
+          w[j+i] -= t;
+          e[j+i] += abs(t);
+        }
+      }
+      // remainder w[m-d+1..m], degree d-1, changed of sign
+      Real * r  = w+m-d+1;
+      Real * er = e+m-d+1;
+      Real tol  = 4 * (m+1) * machepsi;
+      indexType k = 0;
+      for ( indexType i = 0; i < d; ++i ) if ( abs(r[i]) <= tol * er[i] ) r[i] = 0;
+      while ( k < d && r[k] == 0 ) ++k;
+      if ( k == d ) break; // v is the gcd of p and p'
+      Real * s = v+d+1;
+      for ( indexType i = k; i < d; ++i ) s[i-k] = -r[i];
+      deg[np] = d-1-k;
+      scaleToUnit( s, deg[np] );
+      ++np;
+      u = v;
+      v = s;
+    }
+    return np;
+  }
+
+  // sign changes of the sequence at x, the zeros are skipped
+  template <typename Real>
+  static
+  indexType
+  sturmSignChanges(
+    Real const      seq[],
+    indexType const deg[],
+    indexType       np,
+    Real            x
+  ) {
+    indexType nchanges = 0;
+    int       last     = 0;
+    for ( indexType k = 0; k < np; ++k ) {
+      Real px = evalPoly( seq, deg[k], x );
+      int  s  = px > 0 ? 1 : ( px < 0 ? -1 : 0 );
+      if ( s != 0 ) {
+        if ( last != 0 && s != last ) ++nchanges;
+        last = s;
+      }
+      seq += deg[k]+1;
+    }
+    return nchanges;
+  }
+
+  /*\
+   *  Count of the roots of the cubics and quartics of the batch functions,
+   *  the sequence is stored on the stack.
+  \*/
+
+  template <typename Real>
+  static
+  indexType
+  countSmallDegree( Real const p[], indexType degree, Real a, Real b ) {
+    if ( !(a < b) ) return 0;
+    POLYNOMIAL_ROOTS_COUNT( STURM_COUNTS, 1 );
+    if ( noRootsByBound( p, degree, a, b ) ) {
+      POLYNOMIAL_ROOTS_COUNT( STURM_REJECTED, 1 );
+      return 0;
+    }
+    Real      seq[15], work[10]; // degree <= 4
+    indexType deg[5];
+    indexType np = sturmSequence( p, degree, seq, deg, work );
+    return sturmSignChanges( seq, deg, np, a ) - sturmSignChanges( seq, deg, np, b );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename Real>
+  void
+  SturmT<Real>::setup( valueType const op[], indexType Degree ) {
+    seq.resize( size_t((Degree+1)*(Degree+2)/2) );
+    degree.resize( size_t(Degree+1) );
+    std::vector<valueType> work( size_t(2*(Degree+1)) );
+    indexType np = sturmSequence( op, Degree, &seq.front(), &degree.front(), &work.front() );
+    degree.resize( size_t(np) );
+  }
+
+  template <typename Real>
+  indexType
+  SturmT<Real>::signChanges( valueType x ) const {
+    if ( degree.empty() ) return 0;
+    return sturmSignChanges( &seq.front(), &degree.front(), length(), x );
+  }
+
+  template <typename Real>
+  indexType
+  SturmT<Real>::countRoots( valueType a, valueType b ) const {
+    if ( degree.empty() || !(a < b) ) return 0;
+    POLYNOMIAL_ROOTS_COUNT( STURM_COUNTS, 1 );
+    if ( noRootsByBound( &seq.front(), degree[0], a, b ) ) {
+      POLYNOMIAL_ROOTS_COUNT( STURM_REJECTED, 1 );
+      return 0;
+    }
+    return signChanges( a ) - signChanges( b );
+  }
+
+  /*\
+   *  At +infinity the sign of each polynomial is the one of its leading
+   *  coefficient, at -infinity it is changed for odd degree.
+  \*/
+
+  template <typename Real>
+  indexType
+  SturmT<Real>::countRealRoots() const {
+    indexType nminus = 0, nplus = 0;
+    int       lminus = 0, lplus  = 0;
+    valueType const * p = seq.empty() ? NULL : &seq.front();
+    for ( indexType k = 0; k < length(); ++k ) {
+      int s = p[0] > 0 ? 1 : ( p[0] < 0 ? -1 : 0 );
+      if ( s != 0 ) {
+        if ( lplus != 0 && s != lplus ) ++nplus;
+        lplus = s;
+        if ( degree[k] % 2 == 1 ) s = -s;
+        if ( lminus != 0 && s != lminus ) ++nminus;
+        lminus = s;
+      }
+      p += degree[k]+1;
+    }
+    return nminus - nplus;
+  }
+
+  template <typename Real>
+  indexType
+  countRealRoots(
+    Real const op[],
+    indexType  Degree,
+    Real       a,
+    Real       b
+  ) {
+    if ( !(a < b) ) return 0;
+    if ( Degree <= 4 ) return countSmallDegree( op, Degree, a, b );
+    POLYNOMIAL_ROOTS_COUNT( STURM_COUNTS, 1 );
+    if ( noRootsByBound( op, Degree, a, b ) ) {
+      POLYNOMIAL_ROOTS_COUNT( STURM_REJECTED, 1 );
+      return 0;
+    }
+    SturmT<Real> sturm( op, Degree );
+    return sturm.signChanges( a ) - sturm.signChanges( b );
+  }
+
+  template <typename Real>
+  indexType
+  countCubicRootsBatch(
+    indexType  n,
+    Real const A[],
+    Real const B[],
+    Real const C[],
+    Real const D[],
+    Real const a[],
+    Real const b[],
+    indexType  count[]
+  ) {
+    indexType nonzero = 0;
+    for ( indexType i = 0; i < n; ++i ) {
+      Real const p[4] = { A[i], B[i], C[i], D[i] };
+      count[i] = countSmallDegree( p, 3, a[i], b[i] );
+      if ( count[i] > 0 ) ++nonzero;
+    }
+    return nonzero;
+  }
+
+  template <typename Real>
+  indexType
+  countQuarticRootsBatch(
+    indexType  n,
+    Real const A[],
+    Real const B[],
+    Real const C[],
+    Real const D[],
+    Real const E[],
+    Real const a[],
+    Real const b[],
+    indexType  count[]
+  ) {
+    indexType nonzero = 0;
+    for ( indexType i = 0; i < n; ++i ) {
+      Real const p[5] = { A[i], B[i], C[i], D[i], E[i] };
+      count[i] = countSmallDegree( p, 4, a[i], b[i] );
+      if ( count[i] > 0 ) ++nonzero;
+    }
+    return nonzero;
+  }
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                                \
+  template class SturmT<Real>;                                              \
+  template indexType countRealRoots( Real const [], indexType, Real, Real ); \
+  template indexType countCubicRootsBatch( indexType, Real const [],        \
+                                           Real const [], Real const [],    \
+                                           Real const [], Real const [],    \
+                                           Real const [], indexType [] );   \
+  template indexType countQuarticRootsBatch( indexType, Real const [],      \
+                                             Real const [], Real const [],  \
+                                             Real const [], Real const [],  \
+                                             Real const [], Real const [],  \
+                                             indexType [] );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
+}
+
+// EOF: PolynomialRoots-Sturm.cc
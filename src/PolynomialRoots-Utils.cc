@@ -17,6 +17,12 @@
  |                                                                          |
 \*--------------------------------------------------------------------------*/
 
+// the batch kernels compiled for each SIMD level must round as the generic
+// code, so clang must not contract a*b+c also in the inlined header code
+#ifdef __clang__
+#pragma STDC FP_CONTRACT OFF
+#endif
+
 #include "PolynomialRoots.hh"
 #include "PolynomialRoots-Utils.hh"
 
@@ -33,67 +39,162 @@
 
 namespace PolynomialRoots {
 
-  // static valueType const machepsi = std::numeric_limits<valueType>::epsilon();
-
   using std::pair;
-  using std::abs;
-  using std::pow;
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-  // stable computation of polinomial
-  //
-  // op[0] * x^n + .... + op[n-1]*x + op[n]
-  //
-  // (op[0] + op[1]/x.... + op[n]/x^n)*x^n
-  //
-  valueType
-  evalPoly(
-    valueType const op[],
-    indexType       Degree,
-    valueType       x
+  // number of points evaluated together by the batch evalPoly
+  static indexType const evalLanes = 64;
+
+  /*\
+   *  Same evaluation of evalPoly at n points. The points are processed in
+   *  blocks of evalLanes, for |x| > 1 the Horner recurrence runs on 1/x
+   *  with the reversed coefficients. The coefficient of each lane is
+   *  blended with 0/1 weights (exact for finite coefficients) instead of
+   *  a branch and the division is done once per point, so the loop over
+   *  the lanes can be vectorized. The kernel is compiled for each
+   *  SimdLevel and selected by runKernel.
+  \*/
+
+  template <typename Real>
+  struct EvalPolyKernel {
+    static POLYNOMIAL_ROOTS_KERNEL void run(
+      Real const op[], indexType Degree, Real const x[], indexType n, Real res[]
+    );
+  };
+
+  template <typename Real>
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  EvalPolyKernel<Real>::run(
+    Real const op[],
+    indexType  Degree,
+    Real const x[],
+    indexType  n,
+    Real       res[]
   ) {
-    bool reverse = std::abs(x) > 1;
-    if ( reverse ) {
-      valueType res(op[Degree]);
-      valueType xn(1);
+    Real xx[evalLanes], z[evalLanes], m[evalLanes], xn[evalLanes], r[evalLanes];
+    Real wf[evalLanes], wr[evalLanes]; // 1 or 0, weights of the forward and reversed coefficients
+    for ( indexType i0 = 0; i0 < n; i0 += evalLanes ) {
+      // the last block is padded with zeros so that all the loops have evalLanes iterations
+      indexType nl = std::min( evalLanes, n-i0 );
+      std::copy( x+i0, x+i0+nl, xx );
+      std::fill( xx+nl, xx+evalLanes, Real(0) );
+      for ( indexType l = 0; l < evalLanes; ++l ) {
+        wr[l] = abs(xx[l]) > 1 ? 1 : 0;
+        wf[l] = 1-wr[l];
+        m[l]  = xx[l]*wr[l] + wf[l];          // factor of x^n, x or 1
+        z[l]  = xx[l]*wf[l] + wr[l]/m[l];     // evaluation point, x or 1/x
+        xn[l] = 1;
+        r[l]  = op[0]*wf[l] + op[Degree]*wr[l];
+      }
       for ( indexType i = 1; i <= Degree; ++i ) {
-        res = res/x + op[Degree-i];
-        xn *= x;
+        Real cf = op[i];
+        Real cr = op[Degree-i];
+        for ( indexType l = 0; l < evalLanes; ++l ) {
+          r[l]   = r[l]*z[l] + ( cf*wf[l] + cr*wr[l] ); // exact blend of the coefficients
+          xn[l] *= m[l];
+        }
       }
-      res *= xn;
-      return res;
-    } else {
-      valueType res(op[0]);
-      for ( indexType i = 1; i <= Degree; ++i ) res = res*x + op[i];
-      return res;
+      for ( indexType l = 0; l < nl; ++l ) res[i0+l] = r[l]*xn[l];
     }
   }
-    
-  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-  //
-  // op[0] * x^n + .... + op[n-1]*x + op[n]
-  std::complex<valueType>
-  evalPolyC(
-    valueType const                 op[],
-    indexType                       Degree,
-    std::complex<valueType> const & x
+
+  template <typename Real>
+  void
+  evalPoly(
+    Real const op[],
+    indexType  Degree,
+    Real const x[],
+    indexType  n,
+    Real       res[]
   ) {
-    bool reverse = std::abs(x) > 1;
-    if ( reverse ) {
-      std::complex<valueType> res(op[Degree]);
-      std::complex<valueType> xn(1,0);
+    runKernel<EvalPolyKernel<Real> >( op, Degree, x, n, res );
+  }
+
+  /*\
+   *  Same of the batch evalPoly with the complex arithmetic written on the
+   *  real and imaginary parts. The reciprocal of the point is computed
+   *  scaling by the largest component to avoid the overflow of |x|^2.
+  \*/
+
+  template <typename Real>
+  struct EvalPolyCKernel {
+    static POLYNOMIAL_ROOTS_KERNEL void run(
+      Real const op[], indexType Degree, Real const xr[], Real const xi[],
+      indexType n, Real pr[], Real pi[]
+    );
+  };
+
+  template <typename Real>
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  EvalPolyCKernel<Real>::run(
+    Real const op[],
+    indexType  Degree,
+    Real const xr[],
+    Real const xi[],
+    indexType  n,
+    Real       pr[],
+    Real       pi[]
+  ) {
+    Real zr[evalLanes], zi[evalLanes], mr[evalLanes], mi[evalLanes];
+    Real rr[evalLanes], ri[evalLanes], nr[evalLanes], ni[evalLanes];
+    Real wf[evalLanes], wr[evalLanes]; // 1 or 0, weights of the forward and reversed coefficients
+    for ( indexType i0 = 0; i0 < n; i0 += evalLanes ) {
+      // the last block is padded with zeros so that all the loops have evalLanes iterations
+      indexType nl = std::min( evalLanes, n-i0 );
+      std::copy( xr+i0, xr+i0+nl, zr );
+      std::copy( xi+i0, xi+i0+nl, zi );
+      std::fill( zr+nl, zr+evalLanes, Real(0) );
+      std::fill( zi+nl, zi+evalLanes, Real(0) );
+      for ( indexType l = 0; l < evalLanes; ++l ) {
+        wr[l] = zr[l]*zr[l]+zi[l]*zi[l] > 1 ? 1 : 0;
+        wf[l] = 1-wr[l];
+        mr[l] = zr[l]*wr[l] + wf[l];          // factor of x^n, x or 1
+        mi[l] = zi[l]*wr[l];
+        Real s = 1/std::max( abs(mr[l]), abs(mi[l]) );
+        Real a = mr[l]*s;
+        Real b = mi[l]*s;
+        Real d = wr[l]*s/(a*a+b*b);           // 1/m = (a-I*b)*s/(a^2+b^2)
+        zr[l]  = zr[l]*wf[l] + a*d;           // evaluation point, x or 1/x
+        zi[l]  = zi[l]*wf[l] - b*d;
+        nr[l]  = 1;
+        ni[l]  = 0;
+        rr[l]  = op[0]*wf[l] + op[Degree]*wr[l];
+        ri[l]  = 0;
+      }
       for ( indexType i = 1; i <= Degree; ++i ) {
-        res = res/x + op[Degree-i];
-        xn *= x;
+        Real cf = op[i];
+        Real cr = op[Degree-i];
+        for ( indexType l = 0; l < evalLanes; ++l ) {
+          Real t = rr[l]*zr[l] - ri[l]*zi[l] + ( cf*wf[l] + cr*wr[l] );
+          ri[l]  = rr[l]*zi[l] + ri[l]*zr[l];
+          rr[l]  = t;
+          t      = nr[l]*mr[l] - ni[l]*mi[l];
+          ni[l]  = nr[l]*mi[l] + ni[l]*mr[l];
+          nr[l]  = t;
+        }
+      }
+      for ( indexType l = 0; l < nl; ++l ) {
+        pr[i0+l] = rr[l]*nr[l] - ri[l]*ni[l];
+        pi[i0+l] = rr[l]*ni[l] + ri[l]*nr[l];
       }
-      res *= xn;
-      return res;
-    } else {
-      std::complex<valueType> res(op[0]);
-      for ( indexType i = 1; i <= Degree; ++i ) res = res*x + op[i];
-      return res;
     }
   }
+
+  template <typename Real>
+  void
+  evalPolyC(
+    Real const op[],
+    indexType  Degree,
+    Real const xr[],
+    Real const xi[],
+    indexType  n,
+    Real       pr[],
+    Real       pi[]
+  ) {
+    runKernel<EvalPolyCKernel<Real> >( op, Degree, xr, xi, n, pr, pi );
+  }
     
   //============================================================================
     
@@ -106,25 +207,26 @@ namespace PolynomialRoots {
   ..
   */
     
+  template <typename Real>
   static
-  pair<indexType,valueType>
+  pair<indexType,Real>
   scalePolynomial(
     indexType       n, // degree
-    valueType const p[],
-    valueType       ps[]
+    Real const      p[],
+    Real            ps[]
   ) {
     indexType i_max = n;
-    valueType an    = p[n];
-    valueType scale = -1;
+    Real      an    = p[n];
+    Real      scale = -1;
     indexType i = n;
     while ( --i >= 0 ) {
       ps[i] = p[i]/an;
-      valueType scale1 = std::pow( abs(ps[i]), 1.0/(n-i) );
+      Real scale1 = pow( abs(ps[i]), Real(1)/(n-i) );
       if ( scale1 > scale ) { scale = scale1; i_max = i; }
     }
     // scale coeffs
-    pair<indexType,valueType> res(i_max,scale);
-    valueType s = scale;
+    pair<indexType,Real> res(i_max,scale);
+    Real s = scale;
     for ( i = 1; i <= n; ++i, s *= scale ) ps[n-i] /= s;
     ps[n] = 1;
     return res;
@@ -136,23 +238,24 @@ namespace PolynomialRoots {
   .. divide a(x)  by (x-r) so that a(x) = (x-r) * b(x)
   */
     
+  template <typename Real>
   static
   void
   deflatePolynomial(
     indexType       n, // degree
-    valueType const a[],
-    valueType       r,
-    valueType       b[]
+    Real const      a[],
+    Real            r,
+    Real            b[]
   ) {
     // crossover index for forward/backward deflation
     // G. Peters and J. H. Wilkinson.
     // Practical problems arising in the solution of polynomial equations.
     // J. Inst. Math. Appl. 8 (1971), 16–35.
     indexType i_cross = 0;
-    valueType v_cross = abs(a[0]);
-    valueType r1 = r;
+    Real      v_cross = abs(a[0]);
+    Real      r1 = r;
     for ( indexType i = 1; i < n; ++i, r1 *= r ) {
-      valueType v_cross1 = abs(a[i]*r1);
+      Real v_cross1 = abs(a[i]*r1);
       if ( v_cross1 > v_cross )
         { v_cross = v_cross1; i_cross = i; }
     }
@@ -166,7 +269,7 @@ namespace PolynomialRoots {
       for ( indexType j = n-2; j >= i_cross; --j )
         b[j] = a[j+1]+r*b[j+1];
     } else {
-      valueType an = a[n];
+      Real an = a[n];
       if ( i_cross > 0 ) {
         b[0] = -(a[0]/an) / r;
         for ( indexType j = 1; j < i_cross; ++j )
@@ -178,60 +281,381 @@ namespace PolynomialRoots {
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-  // stable computation of polinomial
-  // p0 + p1*x + p2*x^2 + ... + pn*x^n
+  // compensated Horner scheme
+  // S. Graillat, N. Louvet, P. Langlois.
+  // Compensated Horner scheme.
+  // Research Report RR2005-04, Universite de Perpignan (2005).
   //
-  // (p0/x^n + p1/x^(n-1) + p2/(x^(n-2) + ... + pn)*x^n
+  // S. Graillat, V. Menissier-Morain.
+  // Accurate summation, dot product and polynomial evaluation in complex
+  // floating point arithmetic.
+  // Information and Computation 216 (2012), 57-71.
   //
-  #if 0
-  // UNUSED
-  valueType
-  CompHorner(
-    valueType const p[],
-    indexType       Degree,
-    valueType       x
+  // a * x + b = res + err, err is exact for real and up to the rounding
+  // of the sum of the four error terms for complex
+  template <typename Real>
+  static
+  inline
+  void
+  HornerStep( Real a, Real x, Real b, Real & res, Real & err ) {
+    Real tmp, pi, sigma;
+    TwoProduct( a, x, tmp, pi );
+    TwoSum( tmp, b, res, sigma );
+    err = pi+sigma;
+  }
+
+  template <typename Real>
+  static
+  inline
+  void
+  HornerStep(
+    std::complex<Real>   a,
+    std::complex<Real>   x,
+    std::complex<Real>   b,
+    std::complex<Real> & res,
+    std::complex<Real> & err
+  ) {
+    std::complex<Real> tmp, pi, sigma, beta, alpha;
+    TwoProduct( a, x, tmp, pi, sigma, beta );
+    TwoSum( tmp, b, res, alpha );
+    err = (pi+sigma)+(beta+alpha);
+  }
+
+  /*\
+   *  op[0] * x^n + .... + op[n-1]*x + op[n] and its derivatives, T is Real
+   *  or complex. p carries the Horner recurrence and cp the recurrence of
+   *  its rounding errors, the same for dp with the error of p included in
+   *  cdp. Both are evaluated in x (no reversal in 1/x, whose rounding
+   *  would not be compensated). ddp = p''(x)/2 is not compensated.
+  \*/
+
+  template <typename Real, typename T>
+  static
+  inline
+  void
+  compHornerDer(
+    Real const op[],
+    indexType  Degree,
+    T          x,
+    T        & px,
+    T        & dpx,
+    T        & ddpx
   ) {
-    valueType xabs = std::abs(x);
-    bool reverse = xabs > 1;
-    //bool reverse = false;
-    if ( reverse ) x = valueType(1)/x;
-    indexType ii0 = reverse ? Degree : 0;
-    valueType res(p[ii0]);
-    valueType c = 0;
+    T p(op[0]), cp(0), dp(0), cdp(0), ddp(0);
     for ( indexType i = 1; i <= Degree; ++i ) {
-      indexType ii = reverse ? Degree-i : i;
-      valueType tmp, pi, sigma;
-      //TwoProduct( res, x, tmp, pi );
-      //TwoSum( tmp, p[ii], res, sigma );
-      res = res * x + p[ii];
-      //c = c * x + (pi+sigma);
+      T err;
+      ddp = ddp * x + dp;
+      HornerStep( dp, x, p, dp, err );
+      cdp = cdp * x + (cp+err);
+      HornerStep( p, x, T(op[i]), p, err );
+      cp = cp * x + err;
     }
-    //res += c;
-    if ( reverse ) res *= std::pow(x,Degree);
-    return res;
+    px   = p + cp;
+    dpx  = dp + cdp;
+    ddpx = ddp;
   }
-  #endif
-    
+
+  template <typename Real>
+  Real
+  compHorner(
+    Real const op[],
+    indexType  Degree,
+    Real       x
+  ) {
+    Real p(op[0]), cp(0);
+    for ( indexType i = 1; i <= Degree; ++i ) {
+      Real err;
+      HornerStep( p, x, op[i], p, err );
+      cp = cp * x + err;
+    }
+    return p + cp;
+  }
+
+  template <typename Real>
+  std::complex<Real>
+  compHornerC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x
+  ) {
+    std::complex<Real> p(op[0]), cp(0);
+    for ( indexType i = 1; i <= Degree; ++i ) {
+      std::complex<Real> err;
+      HornerStep( p, x, std::complex<Real>(op[i]), p, err );
+      cp = cp * x + err;
+    }
+    return p + cp;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // step d to the smallest root of p + dp * d + ddp * d^2 (Euler method),
+  // d = -2p/(dp+-sqrt(dp^2-4*p*ddp)), a Newton step if there is no real root.
+  // Near a stationary point (close roots) it splits the cluster where
+  // Newton would jump away, for a simple root it converges cubically
+  template <typename Real>
+  static
+  inline
+  bool
+  EulerStep( Real p, Real dp, Real ddp, Real & d ) {
+    Real disc = dp*dp - 4*p*ddp;
+    Real q    = disc < 0 ? dp : (dp + (dp < 0 ? -sqrt(disc) : sqrt(disc)))/2;
+    if ( q == 0 ) return false;
+    d = -p/q;
+    return true;
+  }
+
+  template <typename Real>
+  static
+  inline
+  bool
+  EulerStep(
+    std::complex<Real>   p,
+    std::complex<Real>   dp,
+    std::complex<Real>   ddp,
+    std::complex<Real> & d
+  ) {
+    // principal square root of the discriminant with the real functions,
+    // std::sqrt of a complex needs std::abs of Real (not for __float128)
+    std::complex<Real> disc = dp*dp - Real(4)*p*ddp;
+    Real t = sqrt( (abs(disc) + abs(disc.real()))/2 );
+    std::complex<Real> s;
+    if      ( t == 0 )            s = 0;
+    else if ( disc.real() >= 0 )  s = std::complex<Real>( t, disc.imag()/(2*t) );
+    else                          s = std::complex<Real>( abs(disc.imag())/(2*t),
+                                                          disc.imag() < 0 ? -t : t );
+    std::complex<Real> q = abs(dp+s) >= abs(dp-s) ? dp+s : dp-s;
+    if ( abs(q) == 0 ) return false;
+    d = -Real(2)*p/q;
+    return true;
+  }
+
+  // iterate while the residual computed by compHorner decreases
+  template <typename Real, typename T>
+  static
+  T
+  polishRootT(
+    Real const op[],
+    indexType  Degree,
+    T          x,
+    indexType  maxIter
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    T p, dp, ddp;
+    compHornerDer( op, Degree, x, p, dp, ddp );
+    for ( indexType iter = 0; iter < maxIter && abs(p) != 0; ++iter ) {
+      T d;
+      if ( !EulerStep( p, dp, ddp, d ) ) break;
+      T xn = x + d, pn, dpn, ddpn;
+      compHornerDer( op, Degree, xn, pn, dpn, ddpn );
+      if ( !(abs(pn) < abs(p)) ) break; // no progress, keep x
+      x = xn; p = pn; dp = dpn; ddp = ddpn;
+      if ( abs(d) <= machepsi * abs(x) ) break;
+    }
+    return x;
+  }
+
+  template <typename Real>
+  Real
+  polishRoot(
+    Real const op[],
+    indexType  Degree,
+    Real       x,
+    indexType  maxIter
+  ) {
+    return polishRootT( op, Degree, x, maxIter );
+  }
+
+  template <typename Real>
+  std::complex<Real>
+  polishRootC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x,
+    indexType                  maxIter
+  ) {
+    return polishRootT( op, Degree, x, maxIter );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // number of roots polished together by polishRoots
+  static indexType const polishLanes = 16;
+
+  /*\
+   *  p(z) by the compensated Horner scheme and p'(z) by Horner at the
+   *  points (zr[l],zi[l]), the recurrence of compHornerC written on the
+   *  real and imaginary parts (the coefficients are real) so that the
+   *  loops over the lanes can be vectorized.
+  \*/
+
+  template <typename Real>
+  static
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  compHornerLanes(
+    Real const op[],
+    indexType  Degree,
+    Real const zr[],
+    Real const zi[],
+    Real       pr[],
+    Real       pi[],
+    Real       dr[],
+    Real       di[]
+  ) {
+    Real cr[polishLanes], ci[polishLanes];
+    for ( indexType l = 0; l < polishLanes; ++l ) {
+      pr[l] = op[0]; pi[l] = 0;
+      cr[l] = 0;     ci[l] = 0;
+      dr[l] = 0;     di[l] = 0;
+    }
+    for ( indexType i = 1; i <= Degree; ++i ) {
+      Real a = op[i];
+      for ( indexType l = 0; l < polishLanes; ++l ) {
+        Real t = dr[l]*zr[l] - di[l]*zi[l] + pr[l];
+        di[l]  = dr[l]*zi[l] + di[l]*zr[l] + pi[l];
+        dr[l]  = t;
+        // p*z + a = s + I*z6 + (er + I*ei) exactly up to the sum of the errors
+        Real z1, z2, z3, z4, z5, z6, h1, h2, h3, h4, h5, h6, s, h7;
+        TwoProduct( pr[l], zr[l], z1, h1 );
+        TwoProduct( pi[l], zi[l], z2, h2 );
+        TwoProduct( pr[l], zi[l], z3, h3 );
+        TwoProduct( pi[l], zr[l], z4, h4 );
+        TwoSum( z1, -z2, z5, h5 );
+        TwoSum( z3, z4, z6, h6 );
+        TwoSum( z5, a, s, h7 );
+        Real er = (h1-h2)+(h5+h7);
+        Real ei = (h3+h4)+h6;
+        t      = cr[l]*zr[l] - ci[l]*zi[l] + er;
+        ci[l]  = cr[l]*zi[l] + ci[l]*zr[l] + ei;
+        cr[l]  = t;
+        pr[l]  = s;
+        pi[l]  = z6;
+      }
+    }
+    for ( indexType l = 0; l < polishLanes; ++l ) {
+      pr[l] += cr[l];
+      pi[l] += ci[l];
+    }
+  }
+
+  /*\
+   *  Newton steps on polishLanes roots in lockstep. A step is accepted in
+   *  a lane only if it decreases the residual (infinity norm of p), the
+   *  lane stops when a step is rejected or when the correction is at the
+   *  level of the rounding. The iterations end when all the lanes stopped.
+   *  The padding lanes are never active.
+  \*/
+
+  template <typename Real>
+  struct PolishRootsKernel {
+    static POLYNOMIAL_ROOTS_KERNEL void run(
+      Real const op[], indexType Degree, Real zeror[], Real zeroi[],
+      indexType maxIter, indexType * nstop
+    );
+  };
+
+  template <typename Real>
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  PolishRootsKernel<Real>::run(
+    Real const  op[],
+    indexType   Degree,
+    Real        zeror[],
+    Real        zeroi[],
+    indexType   maxIter,
+    indexType * nstop
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    Real xr[polishLanes], xi[polishLanes], pr[polishLanes], pi[polishLanes];
+    Real dr[polishLanes], di[polishLanes], yr[polishLanes], yi[polishLanes];
+    Real qr[polishLanes], qi[polishLanes], er[polishLanes], ei[polishLanes];
+    Real act[polishLanes], acc[polishLanes]; // 1 or 0, lane still iterating and step accepted
+    *nstop = 0;
+    for ( indexType i0 = 0; i0 < Degree; i0 += polishLanes ) {
+      // the last block is padded with zeros so that all the loops have polishLanes iterations
+      indexType nl = std::min( polishLanes, Degree-i0 );
+      std::copy( zeror+i0, zeror+i0+nl, xr );
+      std::copy( zeroi+i0, zeroi+i0+nl, xi );
+      std::fill( xr+nl, xr+polishLanes, Real(0) );
+      std::fill( xi+nl, xi+polishLanes, Real(0) );
+      compHornerLanes( op, Degree, xr, xi, pr, pi, dr, di );
+      std::fill( act+nl, act+polishLanes, Real(0) );
+      for ( indexType l = 0; l < nl; ++l )
+        act[l] = std::max( abs(pr[l]), abs(pi[l]) ) > 0 ? 1 : 0;
+      for ( indexType iter = 0; iter < maxIter; ++iter ) {
+        Real nact = 0;
+        for ( indexType l = 0; l < polishLanes; ++l ) nact += act[l];
+        if ( nact == 0 ) break;
+        for ( indexType l = 0; l < polishLanes; ++l ) {
+          // p/p' scaled by the largest component of p' to avoid overflow
+          Real s  = 1/std::max( abs(dr[l]), abs(di[l]) );
+          Real ar = dr[l]*s;
+          Real ai = di[l]*s;
+          Real d  = s/(ar*ar+ai*ai);
+          yr[l]   = xr[l] - (pr[l]*ar + pi[l]*ai)*d;
+          yi[l]   = xi[l] - (pi[l]*ar - pr[l]*ai)*d;
+        }
+        compHornerLanes( op, Degree, yr, yi, qr, qi, er, ei );
+        for ( indexType l = 0; l < polishLanes; ++l ) {
+          Real res  = std::max( abs(pr[l]), abs(pi[l]) );
+          Real resn = std::max( abs(qr[l]), abs(qi[l]) );
+          Real dec  = resn < res ? 1 : 0; // 0 also for NaN
+          Real stop = std::max( abs(yr[l]-xr[l]), abs(yi[l]-xi[l]) ) <=
+                      machepsi * std::max( abs(yr[l]), abs(yi[l]) ) ? 1 : 0;
+          acc[l] = dec * act[l];
+          act[l] = acc[l] * (1-stop);
+        }
+        for ( indexType l = 0; l < polishLanes; ++l ) {
+          xr[l]  = acc[l] != 0 ? yr[l] : xr[l];
+          xi[l]  = acc[l] != 0 ? yi[l] : xi[l];
+          pr[l]  = acc[l] != 0 ? qr[l] : pr[l];
+          pi[l]  = acc[l] != 0 ? qi[l] : pi[l];
+          dr[l]  = acc[l] != 0 ? er[l] : dr[l];
+          di[l]  = acc[l] != 0 ? ei[l] : di[l];
+        }
+      }
+      for ( indexType l = 0; l < nl; ++l ) {
+        zeror[i0+l] = xr[l];
+        zeroi[i0+l] = xi[l];
+        if ( act[l] == 0 ) ++*nstop;
+      }
+    }
+  }
+
+  template <typename Real>
+  indexType
+  polishRoots(
+    Real const op[],
+    indexType  Degree,
+    Real       zeror[],
+    Real       zeroi[],
+    indexType  maxIter
+  ) {
+    indexType nstop;
+    runKernel<PolishRootsKernel<Real> >( op, Degree, zeror, zeroi, maxIter, &nstop );
+    return nstop;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   //
   // x^3 + A x^2 + B x + C
+  template <typename Real>
   static
   inline
   void
   scaleCubicMonicPolynomial(
-    valueType   A,
-    valueType   B,
-    valueType   C,
-    valueType & AS,
-    valueType & BS,
-    valueType & CS,
+    Real        A,
+    Real        B,
+    Real        C,
+    Real      & AS,
+    Real      & BS,
+    Real      & CS,
     indexType & i_case,
-    valueType & scale
+    Real      & scale
   ) {
         
-    valueType a = abs(A);
-    valueType b = sqrt(abs(B));
-    valueType c = cbrt(abs(C));
+    Real a = abs(A);
+    Real b = sqrt(abs(B));
+    Real c = cbrt(abs(C));
         
     if ( a < b ) {
       if ( b < c ) i_case = 0; // a < b < c --> c MAX
@@ -266,21 +690,22 @@ namespace PolynomialRoots {
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   //
   // a3*x^3 + a2*x^2 + a1*x + a0 = (x-r)*(a3*x^2+b1*x+b0)
+  template <typename Real>
   static
   void
   deflateCubicPolynomial(
-    valueType   a3,
-    valueType   a2,
-    valueType   a1,
-    valueType   a0,
-    valueType   r,
-    valueType & b1,
-    valueType & b0
+    Real        a3,
+    Real        a2,
+    Real        a1,
+    Real        a0,
+    Real        r,
+    Real      & b1,
+    Real      & b0
   ) {
     indexType i_cross  = 0;
-    valueType r2       = r*r;
-    valueType v_cross  = abs(a0);
-    valueType v_cross1 = abs(a1*r);
+    Real      r2       = r*r;
+    Real      v_cross  = abs(a0);
+    Real      v_cross1 = abs(a1*r);
     if ( v_cross1 > v_cross ) { v_cross = v_cross1; i_cross = 1; }
       v_cross1 = abs(a2*r2);
       if ( v_cross1 > v_cross ) { v_cross = v_cross1; i_cross = 2; }
@@ -294,6 +719,27 @@ namespace PolynomialRoots {
     }
   }
 
+
+  #define POLYNOMIAL_ROOTS_INSTANTIATE(Real)                         \
+  template Real evalPoly( Real const [], indexType, Real );        \
+  template void evalPoly( Real const [], indexType, Real const [], \
+                          indexType, Real [] );                    \
+  template std::complex<Real> evalPolyC( Real const [], indexType, \
+                                         std::complex<Real> const & ); \
+  template void evalPolyC( Real const [], indexType, Real const [], \
+                           Real const [], indexType, Real [], Real [] ); \
+  template Real compHorner( Real const [], indexType, Real );      \
+  template std::complex<Real> compHornerC( Real const [], indexType, \
+                                           std::complex<Real> const & ); \
+  template Real polishRoot( Real const [], indexType, Real, indexType ); \
+  template std::complex<Real> polishRootC( Real const [], indexType, \
+                                           std::complex<Real> const &, \
+                                           indexType );                 \
+  template indexType polishRoots( Real const [], indexType, Real [], Real [], \
+                                  indexType );
+
+  POLYNOMIAL_ROOTS_FOR_ALL_TYPES(POLYNOMIAL_ROOTS_INSTANTIATE)
+
 }
 
 // EOF: PolynomialRoots-Utils.cc
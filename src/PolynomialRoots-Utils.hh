@@ -21,12 +21,17 @@
 #define RPOLY_HH
 
 #include <utility>
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 #include <complex>
 #include <iostream>
 #include <limits>
 
+#ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+#include <quadmath.h>
+#endif
+
 /*
 ..
 .. N. FLOCKE
@@ -44,8 +49,318 @@ namespace PolynomialRoots {
   typedef std::complex<valueType> complexType;
   typedef long long longIntType;
 
-  static int       const bitsValueType = std::numeric_limits<valueType>::digits;
-  static valueType const splitFactor   = (longIntType(1)<<(bitsValueType-1))+1;
+  using std::abs;
+  using std::sqrt;
+  using std::cbrt;
+  using std::hypot;
+  using std::pow;
+  using std::exp;
+  using std::log;
+  using std::cos;
+  using std::sin;
+  using std::acos;
+  using std::frexp;
+  using std::ldexp;
+
+  //! machine epsilon of the floating point type `Real`
+  template <typename Real>
+  inline
+  Real
+  machineEpsilon()
+  { return std::numeric_limits<Real>::epsilon(); }
+
+  //! number of bits of the mantissa of the floating point type `Real`
+  template <typename Real>
+  inline
+  int
+  mantissaBits()
+  { return std::numeric_limits<Real>::digits; }
+
+  //! iteration limit of the Newton loops of the cubic, quartic and hexic
+  //! solvers and of their batch kernels, it also ends a loop on a NaN
+  static indexType const maxNewtonIter = 50;
+
+  #ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+  // std::numeric_limits and <cmath> do not support quad precision,
+  // map the functions used by the solvers to libquadmath
+  template <>
+  inline
+  __float128
+  machineEpsilon<__float128>()
+  { return ldexpq( 1, 1-FLT128_MANT_DIG ); } // FLT128_EPSILON needs the Q suffix
+
+  template <>
+  inline
+  int
+  mantissaBits<__float128>()
+  { return FLT128_MANT_DIG; }
+
+  inline __float128 abs( __float128 x )   { return fabsq(x); }
+  inline __float128 sqrt( __float128 x )  { return sqrtq(x); }
+  inline __float128 cbrt( __float128 x )  { return cbrtq(x); }
+  inline __float128 exp( __float128 x )   { return expq(x); }
+  inline __float128 log( __float128 x )   { return logq(x); }
+  inline __float128 cos( __float128 x )   { return cosq(x); }
+  inline __float128 sin( __float128 x )   { return sinq(x); }
+  inline __float128 acos( __float128 x )  { return acosq(x); }
+  inline __float128 hypot( __float128 x, __float128 y ) { return hypotq(x,y); }
+  inline __float128 pow( __float128 x, __float128 y )   { return powq(x,y); }
+  inline __float128 frexp( __float128 x, int * e )      { return frexpq(x,e); }
+  inline __float128 ldexp( __float128 x, int e )        { return ldexpq(x,e); }
+  inline __float128 abs( std::complex<__float128> const & z )
+  { return hypotq(z.real(),z.imag()); }
+  #endif
+
+  //! apply `MACRO` to all the floating point types supported by the library
+  #ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+    #define POLYNOMIAL_ROOTS_FOR_ALL_TYPES(MACRO) \
+      MACRO(float) MACRO(double) MACRO(long double) MACRO(__float128)
+  #else
+    #define POLYNOMIAL_ROOTS_FOR_ALL_TYPES(MACRO) \
+      MACRO(float) MACRO(double) MACRO(long double)
+  #endif
+
+  //! add `n` to the counter `c` of the calling thread (see `SolverStats`)
+  void countEvent( int c, unsigned long long n );
+
+  //! update a counter of `SolverStats`, expands to nothing without `POLYNOMIAL_ROOTS_STATS`
+  #ifdef POLYNOMIAL_ROOTS_STATS
+    #define POLYNOMIAL_ROOTS_COUNT(COUNTER,N) \
+      PolynomialRoots::countEvent( PolynomialRoots::SolverStats::COUNTER, N )
+  #else
+    #define POLYNOMIAL_ROOTS_COUNT(COUNTER,N)
+  #endif
+
+  //! runtime dispatch of the batch kernels (see `SimdLevel`), GCC and Clang on x86
+  #if ( defined(__GNUC__) || defined(__clang__) ) && \
+      ( defined(__x86_64__) || defined(__i386__) ) && \
+      !defined(POLYNOMIAL_ROOTS_NO_DISPATCH)
+    #define POLYNOMIAL_ROOTS_DISPATCH
+  #endif
+
+  //! a batch kernel, the body of `K::run` is compiled in each `runKernel*` variant
+  #ifdef POLYNOMIAL_ROOTS_DISPATCH
+    #define POLYNOMIAL_ROOTS_KERNEL inline __attribute__((always_inline))
+  #else
+    #define POLYNOMIAL_ROOTS_KERNEL inline
+  #endif
+
+  #ifdef POLYNOMIAL_ROOTS_DISPATCH
+
+  // the variants must round as the generic code: no "fma" in the targets
+  // and no contraction of a*b+c (AVX-512 has its own fused multiply-add),
+  // with clang the .cc files of the kernels set "STDC FP_CONTRACT OFF"
+  #ifdef __clang__
+    #define POLYNOMIAL_ROOTS_TARGET(ISA) __attribute__((target(ISA))) __attribute__((noinline))
+    #define POLYNOMIAL_ROOTS_TARGET_AVX512 "avx512f,avx512vl,avx512dq,avx2"
+  #else
+    #define POLYNOMIAL_ROOTS_TARGET(ISA) \
+      __attribute__((target(ISA))) __attribute__((noinline)) __attribute__((optimize("fp-contract=off")))
+    #define POLYNOMIAL_ROOTS_TARGET_AVX512 "avx512f,avx512vl,avx512dq,avx2,prefer-vector-width=512"
+  #endif
+
+  template <typename K, typename... Args>
+  POLYNOMIAL_ROOTS_TARGET("sse4.2")
+  void runKernelSSE42( Args... args ) { K::run( args... ); }
+
+  template <typename K, typename... Args>
+  POLYNOMIAL_ROOTS_TARGET("avx2")
+  void runKernelAVX2( Args... args ) { K::run( args... ); }
+
+  template <typename K, typename... Args>
+  POLYNOMIAL_ROOTS_TARGET(POLYNOMIAL_ROOTS_TARGET_AVX512)
+  void runKernelAVX512( Args... args ) { K::run( args... ); }
+
+  #endif
+
+  //! run the kernel `K` compiled for the level returned by `simdLevel()`
+  template <typename K, typename... Args>
+  inline
+  void
+  runKernel( Args... args ) {
+    #ifdef POLYNOMIAL_ROOTS_DISPATCH
+    switch ( simdLevel() ) {
+      case SIMD_AVX512: runKernelAVX512<K>( args... ); return;
+      case SIMD_AVX2:   runKernelAVX2<K>( args... );   return;
+      case SIMD_SSE42:  runKernelSSE42<K>( args... );  return;
+      case SIMD_GENERIC: break;
+    }
+    #endif
+    K::run( args... );
+  }
+
+  /*\
+   *  The Newton iteration with bisection fallback of NewtonBisection applied
+   *  to the first m <= N polynomials of a batch in lockstep. `eval(l,x,p,dp)`
+   *  computes the polynomial of lane l and its derivative at x, `eval(l,x)`
+   *  the polynomial only. The arrays have N entries, the lanes after m are
+   *  padding (x is any value where eval is finite) and are never active, so
+   *  that all the loops have N iterations. The loops are free of branches
+   *  and are vectorized by the compiler: the flags and counters are 0/1
+   *  values of type Real (loops mixing floating point and integer lanes are
+   *  not vectorized) and every loop does either arithmetic or selects, an
+   *  operation used only under a condition is moved by the compiler into a
+   *  branch. Lanes that start oscillating are completed by bisection one by
+   *  one. NEWTON_ITER, BISECTION and BISECTION_ITER are the `SolverStats`
+   *  counters updated.
+  \*/
+
+  template <
+    indexType N,
+    int       NEWTON_ITER,
+    int       BISECTION,
+    int       BISECTION_ITER,
+    typename  Real,
+    typename  Eval
+  >
+  POLYNOMIAL_ROOTS_KERNEL
+  void
+  NewtonBisectionLanes(
+    indexType       m,
+    Eval const    & eval,
+    Real            x[],
+    indexType       iter[]
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    Real t[N], s[N], u[N];
+    Real oscillate[N], done[N], it[N];
+    Real p[N], xn[N], active[N], conv[N];
+    Real osc[N], lower[N], upper[N];
+
+    for ( indexType l = 0; l < N; ++l ) {
+      Real pp, dp;
+      eval( l, x[l], pp, dp );
+      t[l]         = pp; // save p(x) for sign comparison
+      x[l]        -= pp/dp; // 1st improved root
+      s[l]         = u[l] = 0;
+      it[l]        = 1;
+      oscillate[l] = 0;
+      done[l]      = l < m ? 0 : 1;
+    }
+
+    // all the lanes start with iter = 1 like NewtonBisection
+    Real nactive = Real(m);
+    for ( indexType k = 1; nactive > 0 && k < maxNewtonIter; ++k ) {
+      for ( indexType l = 0; l < N; ++l ) {
+        Real dp;
+        eval( l, x[l], p[l], dp );
+        Real dx = p[l]/dp; // Newton correction
+        xn[l]    = x[l] - dx; // new Newton root
+        osc[l]   = p[l]*t[l] < 0 ? 1 : 0; // does Newton start oscillating ?
+        lower[l] = p[l] < 0 ? 1 : 0;
+        conv[l]  = abs(dx) <= abs(xn[l]) * machepsi ? 1 : 0;
+      }
+      for ( indexType l = 0; l < N; ++l ) {
+        active[l]     = 1-done[l];
+        osc[l]       *= active[l];
+        lower[l]     *= osc[l];
+        upper[l]      = osc[l]-lower[l];
+        oscillate[l] += lower[l]; // increment oscillation counter
+        it[l]        += active[l];
+      }
+      for ( indexType l = 0; l < N; ++l ) {
+        s[l]    = lower[l]     != 0 ? x[l]  : s[l]; // save lower bisection bound
+        u[l]    = upper[l]     != 0 ? x[l]  : u[l]; // save upper bisection bound
+        t[l]    = osc[l]       != 0 ? p[l]  : t[l]; // save current p(x)
+        x[l]    = active[l]    != 0 ? xn[l] : x[l];
+        done[l] = oscillate[l] >  2 ? 1     : done[l];
+        done[l] = conv[l]      != 0 ? 1     : done[l];
+      }
+      nactive = 0;
+      for ( indexType l = 0; l < N; ++l ) nactive += 1-done[l];
+    }
+
+    for ( indexType l = 0; l < m; ++l ) {
+      iter[l] = indexType(it[l]);
+      #ifdef POLYNOMIAL_ROOTS_STATS
+      countEvent( NEWTON_ITER, iter[l] );
+      #endif
+      if ( oscillate[l] <= 2 ) continue;
+      #ifdef POLYNOMIAL_ROOTS_STATS
+      countEvent( BISECTION, 1 );
+      #endif
+      Real tt = u[l] - s[l]; // initial bisection interval
+      Real xx = x[l], ss = s[l], uu = u[l];
+      while ( abs(tt) > abs(xx) * machepsi ) { // bisection iterates
+        ++iter[l];
+        #ifdef POLYNOMIAL_ROOTS_STATS
+        countEvent( BISECTION_ITER, 1 );
+        #endif
+        Real pp = eval( l, xx );
+        if ( pp < 0 ) ss = xx;
+        else          uu = xx; // keep bracket on root
+        tt = (uu-ss)/2; // new bisection interval
+        xx = ss + tt;   // new bisection root
+      }
+      x[l] = xx;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // stable computation of polinomial, defined here for the header-only
+  // Quadratic and Cubic of PolynomialRoots-inline.hh
+  //
+  // op[0] * x^n + .... + op[n-1]*x + op[n]
+  //
+  // (op[0] + op[1]/x.... + op[n]/x^n)*x^n
+  //
+  template <typename Real>
+  Real
+  evalPoly(
+    Real const      op[],
+    indexType       Degree,
+    Real            x
+  ) {
+    bool reverse = abs(x) > 1;
+    if ( reverse ) {
+      Real res(op[Degree]);
+      Real xn(1);
+      for ( indexType i = 1; i <= Degree; ++i ) {
+        res = res/x + op[Degree-i];
+        xn *= x;
+      }
+      res *= xn;
+      return res;
+    } else {
+      Real res(op[0]);
+      for ( indexType i = 1; i <= Degree; ++i ) res = res*x + op[i];
+      return res;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  //
+  // op[0] * x^n + .... + op[n-1]*x + op[n]
+  template <typename Real>
+  std::complex<Real>
+  evalPolyC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x
+  ) {
+    bool reverse = abs(x) > 1;
+    if ( reverse ) {
+      std::complex<Real> res(op[Degree]);
+      std::complex<Real> xn(1,0);
+      for ( indexType i = 1; i <= Degree; ++i ) {
+        res = res/x + op[Degree-i];
+        xn *= x;
+      }
+      res *= xn;
+      return res;
+    } else {
+      std::complex<Real> res(op[0]);
+      for ( indexType i = 1; i <= Degree; ++i ) res = res*x + op[i];
+      return res;
+    }
+  }
+
+  //! Veltkamp splitting factor \f$ 2^{\lceil t/2 \rceil}+1 \f$, `t` bits of the mantissa
+  template <typename Real>
+  inline
+  Real
+  splitFactor()
+  { return ldexp( Real(1), (mantissaBits<Real>()+1)/2 ) + 1; }
 
   /*
   ||         _   _ _
@@ -56,85 +371,224 @@ namespace PolynomialRoots {
   */
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // a + b = x + err
-  static
+  template <typename Real>
   inline
   void
   TwoSum(
-    valueType   a,
-    valueType   b,
-    valueType & x,
-    valueType & err
+    Real   a,
+    Real   b,
+    Real & x,
+    Real & err
   ) {
     x = a+b;
-    valueType z = x-a;
+    Real z = x-a;
     err = (a-(x-z))+(b-z);
   }
 
-  static
+  template <typename Real>
   inline
   void
   TwoSum(
-    complexType   a,
-    complexType   b,
-    complexType & x,
-    complexType & err
+    std::complex<Real>   a,
+    std::complex<Real>   b,
+    std::complex<Real> & x,
+    std::complex<Real> & err
   ) {
-    valueType s1, e1, s2, e2;
+    Real s1, e1, s2, e2;
     TwoSum( a.real(), b.real(), s1, e1 );
     TwoSum( a.imag(), b.imag(), s2, e2 );
-    x   = complexType(s1,s2);
-    err = complexType(e1,e2);
+    x   = std::complex<Real>(s1,s2);
+    err = std::complex<Real>(e1,e2);
   }
 
   // a = x + y
-  static
+  template <typename Real>
   inline
   void
-  Split( valueType a, valueType & x, valueType & y ) {
-    valueType c = splitFactor*a;
+  Split( Real a, Real & x, Real & y ) {
+    Real c = splitFactor<Real>()*a;
     x = c-(c-a);
     y = a-x;
   }
 
   // a * b = x + err
-  static
+  template <typename Real>
   inline
   void
   TwoProduct(
-    valueType   a,
-    valueType   b,
-    valueType & x,
-    valueType & err
+    Real   a,
+    Real   b,
+    Real & x,
+    Real & err
   ) {
-    valueType a1, a2, b1, b2;
+    Real a1, a2, b1, b2;
     Split( a, a1, a2 );
     Split( b, b1, b2 );
     x   = a*b;
     err = a2*b2-(((x-a1*b1)-a2*b1)-a1*b2);
   }
 
-  static
+  template <typename Real>
   inline
   void
   TwoProduct(
-    complexType   a,
-    complexType   b,
-    complexType & p,
-    complexType & e,
-    complexType & f,
-    complexType & g
+    std::complex<Real>   a,
+    std::complex<Real>   b,
+    std::complex<Real> & p,
+    std::complex<Real> & e,
+    std::complex<Real> & f,
+    std::complex<Real> & g
   ) {
-    valueType z1, z2, z3, z4, z5, z6, h1, h2, h3, h4, h5, h6;
+    Real z1, z2, z3, z4, z5, z6, h1, h2, h3, h4, h5, h6;
     TwoProduct(a.real(), b.real(), z1, h1 );
     TwoProduct(a.imag(), b.imag(), z2, h2 );
     TwoProduct(a.real(), b.imag(), z3, h3 );
     TwoProduct(a.imag(), b.real(), z4, h4 );
     TwoSum(z1, -z2, z5, h5);
     TwoSum(z3, z4, z6, h6);
-    p = complexType(z5,z6);
-    e = complexType(h1,h3);
-    f = complexType(-h2,h4);
-    g = complexType(h5,h6);
+    p = std::complex<Real>(z5,z6);
+    e = std::complex<Real>(h1,h3);
+    f = std::complex<Real>(-h2,h4);
+    g = std::complex<Real>(h5,h6);
+  }
+
+  /*
+  ||   _       _                       _
+  ||  (_)_ __ | |_ ___ _ ____   ____ _| |
+  ||  | | '_ \| __/ _ \ '__\ \ / / _` | |
+  ||  | | | | | ||  __/ |   \ V / (_| | |
+  ||  |_|_| |_|\__\___|_|    \_/ \__,_|_|
+  */
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // p(x) and p'(x), p[0] is the leading coefficient
+  template <typename Real>
+  inline
+  void
+  evalPolyDPoly(
+    Real const p[],
+    indexType  degree,
+    Real       x,
+    Real     & px,
+    Real     & dpx
+  ) {
+    px  = p[0];
+    dpx = 0;
+    for ( indexType i = 1; i <= degree; ++i ) {
+      dpx = dpx * x + px;
+      px  = px  * x + p[i];
+    }
+  }
+
+  /*\
+   *  Find the smallest root in [lo,hi] of the polynomial p of degree `degree`
+   *  given its nst real stationary points st[] in increasing order.
+   *  Between two consecutive stationary points p is monotone, so the pieces
+   *  of [lo,hi] are checked from the left for a change of sign and the first
+   *  bracketed root is refined by Newton iterations safeguarded by bisection.
+   *  A stationary point where p vanishes within rounding is a multiple root.
+   *  Return false if there are no roots in [lo,hi].
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  firstRootInInterval(
+    Real const p[],
+    indexType  degree,
+    Real const st[],
+    indexType  nst,
+    Real       lo,
+    Real       hi,
+    Real     & x
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    if ( !(lo <= hi) ) return false;
+    Real a = lo, pa, dp;
+    evalPolyDPoly( p, degree, a, pa, dp );
+    if ( pa == 0 ) { x = a; return true; }
+    for ( indexType k = 0; k <= nst; ++k ) {
+      bool stationary = k < nst;
+      Real b = stationary ? st[k] : hi;
+      if ( b <= a ) continue;
+      if ( b > hi ) { b = hi; stationary = false; }
+      Real pb;
+      evalPolyDPoly( p, degree, b, pb, dp );
+      if ( (pa < 0) != (pb < 0) || pb == 0 ) {
+        if ( pb == 0 ) { x = b; return true; }
+        // Newton iterations on the bracket [a,b], p(a)*p(b) < 0
+        Real s = a, u = b, ps = pa;
+        x = a - pa*(b-a)/(pb-pa); // secant guess
+        for ( indexType iter = 0; iter < 100; ++iter ) {
+          Real px;
+          evalPolyDPoly( p, degree, x, px, dp );
+          if ( px == 0 ) return true;
+          if ( (px < 0) == (ps < 0) ) { s = x; ps = px; }
+          else                        u = x;
+          Real xn = x - px/dp;
+          if ( !(xn > s && xn < u) ) xn = (s+u)/2; // also catch dp == 0
+          bool converged = abs(xn-x) <= machepsi * abs(xn) ||
+                           u-s <= machepsi * std::max(abs(s),abs(u));
+          x = xn;
+          if ( converged ) break;
+        }
+        return true;
+      }
+      if ( stationary ) {
+        // touching root: |p(b)| below the rounding error of the evaluation
+        Real bound = 0, absb = abs(b);
+        for ( indexType i = 0; i <= degree; ++i ) bound = bound * absb + abs(p[i]);
+        if ( abs(pb) <= 4 * degree * machepsi * bound ) { x = b; return true; }
+      }
+      if ( b >= hi ) break;
+      a = b; pa = pb;
+    }
+    return false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  /*\
+   *  Solve a single polynomial of degree `degree` choosing the solver
+   *  by the degree, return the same error codes of `roots`.
+  \*/
+
+  template <typename Real>
+  inline
+  indexType
+  solvePolynomial(
+    indexType                      degree,
+    Real const                     op[],
+    Real                           zeror[],
+    Real                           zeroi[],
+    JenkinsTraubWorkspaceT<Real> & work
+  ) {
+    if ( degree < 1 ) return -1;
+    if ( isZero(op[0]) ) return -2;
+    switch ( degree ) {
+    case 2: {
+      QuadraticT<Real> solve( op[0], op[1], op[2] );
+      solve.getRoot0( zeror[0], zeroi[0] );
+      solve.getRoot1( zeror[1], zeroi[1] );
+      return 0;
+    }
+    case 3: {
+      CubicT<Real> solve( op[0], op[1], op[2], op[3] );
+      solve.getRoot0( zeror[0], zeroi[0] );
+      solve.getRoot1( zeror[1], zeroi[1] );
+      solve.getRoot2( zeror[2], zeroi[2] );
+      return 0;
+    }
+    case 4: {
+      QuarticT<Real> solve( op[0], op[1], op[2], op[3], op[4] );
+      solve.getRoot0( zeror[0], zeroi[0] );
+      solve.getRoot1( zeror[1], zeroi[1] );
+      solve.getRoot2( zeror[2], zeroi[2] );
+      solve.getRoot3( zeror[3], zeroi[3] );
+      return 0;
+    }
+    default:
+      return roots( work, op, degree, zeror, zeroi );
+    }
   }
 
 }
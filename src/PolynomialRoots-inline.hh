@@ -0,0 +1,1216 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2017                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Universita` degli Studi di Trento                                   |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*
+.. Definitions of the members of QuadraticT and CubicT and of the functions
+.. they use. Including this header instead of (or after) PolynomialRoots.hh
+.. makes the quadratic and cubic solvers visible to the compiler, so that they
+.. can be inlined in the caller and the computations with constant
+.. coefficients folded, without link time optimization. The scalar evalPoly
+.. and evalPolyC used by eval, check and info are defined in
+.. PolynomialRoots-Utils.hh, so the library is not needed for Quadratic and
+.. Cubic unless POLYNOMIAL_ROOTS_STATS is defined.
+*/
+
+#ifndef POLYNOMIAL_ROOTS_INLINE_HH
+#define POLYNOMIAL_ROOTS_INLINE_HH
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+#ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+#include "PolynomialRoots-CubicTable.hh" // generated at build time by tools/gen_cubic_table.cc
+#endif
+
+namespace PolynomialRoots {
+
+  /*\
+   |    ___                  _           _   _
+   |   / _ \ _   _  __ _  __| |_ __ __ _| |_(_) ___
+   |  | | | | | | |/ _` |/ _` | '__/ _` | __| |/ __|
+   |  | |_| | |_| | (_| | (_| | | | (_| | |_| | (__
+   |   \__\_\\__,_|\__,_|\__,_|_|  \__,_|\__|_|\___|
+  \*/
+
+  template <typename Real>
+  inline
+  indexType
+  QuadraticT<Real>::getRealRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( !cplx ) {
+      r[nr++] = r0;
+      if ( nrts > 1 ) r[nr++] = r1;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  indexType
+  QuadraticT<Real>::getPositiveRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( !cplx ) {
+      if ( r0 > 0 ) r[nr++] = r0;
+      if ( nrts > 1 && r1 > 0 ) r[nr++] = r1;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  indexType
+  QuadraticT<Real>::getNegativeRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( !cplx ) {
+      if ( r0 < 0 ) r[nr++] = r0;
+      if ( nrts > 1 && r1 < 0 ) r[nr++] = r1;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  void
+  QuadraticT<Real>::eval( valueType x, valueType & p, valueType & dp ) const {
+    valueType const & A = ABC[0];
+    valueType const & B = ABC[1];
+    valueType const & C = ABC[2];
+    if ( abs(x) > 1 ) {
+      valueType z  = 1/x;
+      valueType x2 = x*x;
+      p = ((C*z+B)*z+A)*x2;
+    } else {
+      p = (A*x+B)*x+C;
+    }
+    dp = 2*A*x+B;
+  }
+
+  /*\
+   *  Calculate the zeros of the quadratic a*z^2 + b*z + c.
+   *  The quadratic formula, modified to avoid overflow, is used
+   *  to find the larger zero if the zeros are real and both
+   *  are complex. The smaller real zero is found directly from
+   *  the product of the zeros c/a.
+  \*/
+
+  template <typename Real>
+  inline
+  void
+  QuadraticT<Real>::findRoots() {
+    valueType const & A = ABC[0];
+    valueType const & B = ABC[1];
+    valueType const & C = ABC[2];
+
+    r0 = r1 = 0;
+    nrts = 0;
+    cplx = dblx = false;
+
+    if ( isZero(A) ) { // less than two roots b*z + c = 0
+      if ( !isZero(B) ) { nrts = 1; r0 = -C/B; }
+    } else if ( isZero(C) ) { // a*z^2 + b*z  = 0
+      nrts = 2;
+      dblx = isZero(B);
+      if ( !dblx ) {
+        r0 = -B/A;
+        if ( r0 < 0 ) std::swap(r0,r1);
+      }
+    } else { // Compute discriminant avoiding overflow.
+      valueType hb    = B/2; // b now b/2
+      valueType abs_b = abs(hb);
+      valueType abs_c = abs(C);
+      valueType e, d;
+      if ( abs_b < abs_c ) {
+        e = C < 0 ? -A : A;
+        e = (hb*hb)-e*abs_c;
+        d = sqrt(abs(e));
+      } else {
+        e = 1 - (A/hb)*(C/hb);
+        d = sqrt(abs(e))*abs_b;
+      }
+      nrts = 2;
+      cplx = e < 0;
+      if ( cplx ) {
+        // complex conjugate zeros
+        r0 = -hb/A;         // real part
+        r1 = abs(d/A); // immaginary part
+      } else {
+        // real zeros
+        dblx = isZero(d);
+        if ( dblx ) {
+          r0 = r1 = -hb/A;
+        } else {
+          if ( hb >= 0 ) d = -d;
+          r0 = (d-hb)/A;
+          //r1 = (-d-hb)/a;
+          if ( !isZero(r0) ) r1 = (C/r0)/A;
+          if ( r0 > r1 ) std::swap(r0,r1); // order roots
+        }
+      }
+    }
+  }
+
+  template <typename Real>
+  inline
+  void
+  QuadraticT<Real>::info( std::ostream & s ) const {
+    valueType const & A = ABC[0];
+    valueType const & B = ABC[1];
+    valueType const & C = ABC[2];
+    s << "\npoly A=" << A << " B=" << B << " C=" << C
+      << "\nn. roots = " << nrts
+      << "\ncomplex  = " << (cplx?"YES":"NO")
+      << "\ndouble   = " << (dblx?"YES":"NO");
+    if ( cplx ) {
+      s << "\nx0 = (" << r0 << "," <<  r1 << ')'
+        << "\nx1 = (" << r0 << "," << -r1 << ')';
+    } else if ( dblx ) {
+      s << "\nx0 = x1 = " << r0;
+    } else if ( nrts == 1 ) {
+      s << "\nx0 = " << r0;
+    } else if ( nrts == 2 ) {
+      s << "\nx0 = " << r0
+        << "\nx1 = " << r1;
+    }
+    s << '\n';
+  }
+
+  template <typename Real>
+  inline
+  bool
+  QuadraticT<Real>::check( std::ostream & s ) const {
+    valueType const & A = ABC[0];
+    valueType const & B = ABC[1];
+    valueType const & C = ABC[2];
+    valueType const machepsi = machineEpsilon<valueType>();
+    bool ok = true;
+    valueType epsi = 10 * ( abs(A) +
+                            abs(B) +
+                            abs(C) ) * machepsi;
+    if ( cplx ) {
+      valueType z0 = abs(eval( root0() ));
+      valueType z1 = abs(eval( root1() ));
+      s << "|p(r0)| = " << z0
+        << "\n|p(r1)| = " << z1
+        << '\n';
+      ok = z0 < epsi && z1 < epsi;
+    } else if ( nrts == 1 ) {
+      valueType z0 = eval( real_root0() );
+      s << "p(r0) = " << z0  << '\n';
+      ok = abs(z0) < epsi;
+    } else if ( nrts == 2 ) {
+      valueType z0 = eval( real_root0() );
+      valueType z1 = eval( real_root1() );
+      s << "p(r0) = " << z0
+        << "\np(r1) = " << z1
+        << '\n';
+      ok = abs(z0) < epsi && abs(z1) < epsi;
+    }
+    return ok;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |    ____      _     _
+   |   / ___|   _| |__ (_) ___
+   |  | |  | | | | '_ \| |/ __|
+   |  | |__| |_| | |_) | | (__
+   |   \____\__,_|_.__/|_|\___|
+  \*/
+
+  template <typename Real>
+  inline
+  indexType
+  CubicT<Real>::getRealRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( cplx ) {
+      if ( nrts > 2 ) r[nr++] = r2;
+    } else {
+      if ( nrts > 0 ) r[nr++] = r0;
+      if ( nrts > 1 ) r[nr++] = r1;
+      if ( nrts > 2 ) r[nr++] = r2;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  indexType
+  CubicT<Real>::getPositiveRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( cplx ) {
+      if ( nrts > 2 && r2 > 0  ) r[nr++] = r2;
+    } else {
+      if ( nrts > 0 && r0 > 0 ) r[nr++] = r0;
+      if ( nrts > 1 && r1 > 0 ) r[nr++] = r1;
+      if ( nrts > 2 && r2 > 0 ) r[nr++] = r2;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  indexType
+  CubicT<Real>::getNegativeRoots( valueType r[] ) const {
+    indexType nr = 0;
+    if ( cplx ) {
+      if ( nrts > 2 && r2 < 0  ) r[nr++] = r2;
+    } else {
+      if ( nrts > 0 && r0 < 0 ) r[nr++] = r0;
+      if ( nrts > 1 && r1 < 0 ) r[nr++] = r1;
+      if ( nrts > 2 && r2 < 0 ) r[nr++] = r2;
+    }
+    return nr;
+  }
+
+  template <typename Real>
+  inline
+  void
+  CubicT<Real>::eval( valueType x, valueType & p, valueType & dp ) const {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    if ( abs(x) > 1 ) {
+      valueType x2 = x*x;
+      valueType x3 = x2*x;
+      p  = (((D/x+C)/x+B)/x+A)*x3;
+      dp = ((C/x+2*B)/x+3*A)*x2;
+    } else {
+      p  = ((A*x+B)*x+C)*x+D;
+      dp = (3*A*x+2*B)*x+C;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  template <typename Real>
+  inline
+  Real
+  guess1( Real const a[3] ) {
+    Real const p = Real(1.09574);
+    Real const q = Real(-3.239E-1);
+    Real const r = Real(-3.239E-1);
+    Real const s = Real(9.57439E-2);
+    return p+q*a[1]+r*a[2]+s*a[1]*a[2];
+  }
+
+  template <typename Real>
+  inline
+  Real
+  guess2( Real const a[3] ) {
+    Real const p = Real(-1.09574);
+    Real const q = Real(3.239E-1);
+    Real const r = Real(-3.239E-1);
+    Real const s = Real(9.57439E-2);
+    return p+q*a[1]+r*a[2]+s*a[1]*a[2];
+  }
+
+  template <typename Real>
+  inline
+  Real
+  guess3( Real const a[3] ) {
+    Real const p = Real(1.14413);
+    Real const q = Real(-2.75509E-1);
+    Real const r = Real(-4.45578E-1);
+    Real const s = Real(-2.59342E-2);
+    Real t = a[2]/3;
+    if ( a[0] < t*(2*t*t-1) ) return  p+q*a[0]+r*a[2]+s*a[0]*a[2];
+    else                      return -p+q*a[0]+r*a[2]-s*a[0]*a[2];
+  }
+
+  template <typename Real>
+  inline
+  Real
+  guess4( Real const a[3] ) {
+    Real const q = Real(-7.71845E-1);
+    Real const s = Real(-2.28155E-1);
+    if ( a[0] > 0 ) return (q+s*a[2])*a[0];
+    else            return (q-s*a[2])*a[0];
+  }
+
+  template <typename Real>
+  inline
+  Real
+  guess5( Real const a[3] ) {
+    Real const third   = Real(1)/3;
+    Real const two27th = Real(2)/27;
+    Real p, q, r, s;
+    Real tmp = two27th-a[1]/3;
+    if ( a[1] <= third ) {
+      if ( a[0] < tmp ) {
+        p =  Real(8.78558E-1);
+        q = -Real(5.71888E-1);
+        r = -Real(7.11154E-1);
+        s = -Real(3.22313E-1);
+      } else {
+        p = -Real(1.92823E-1);
+        q = -Real(5.66324E-1);
+        r =  Real(5.05734E-1);
+        s = -Real(2.64881E-1);
+      }
+    } else {
+      if ( a[0] < tmp ) {
+        p = Real(1.19748);
+        q = -Real(2.83772E-1);
+        r = -Real(8.37476E-1);
+        s = -Real(3.56228E-1);
+      } else {
+        p = -Real(3.45219E-1);
+        q = -Real(4.01231E-1);
+        r =  Real(2.07216E-1);
+        s = -Real(4.45532E-3);
+      }
+    }
+    return p+q*a[0]+r*a[1]+s*a[0]*a[1];
+  }
+
+  template <typename Real>
+  inline
+  Real guess6( Real const a[3] ) {
+    Real const third   = Real(1)/3;
+    Real const two27th = Real(2)/27;
+    Real p, q, r, s;
+    Real tmp = a[1]/3-two27th;
+    if ( a[1] <= third ) {
+      if ( a[0] > tmp ) {
+        p = -Real(8.78558E-1);
+        q = -Real(5.71888E-1);
+        r =  Real(7.11154E-1);
+        s = -Real(3.22313E-1);
+      } else {
+        p =  Real(1.92823E-1);
+        q = -Real(5.66324E-1);
+        r = -Real(5.05734E-1);
+        s = -Real(2.64881E-1);
+      }
+    } else {
+      if ( a[0] > tmp ) {
+        p = -Real(1.19748);
+        q = -Real(2.83772E-1);
+        r =  Real(8.37476E-1);
+        s = -Real(3.56228E-1);
+      } else {
+        p =  Real(3.45219E-1);
+        q = -Real(4.01231E-1);
+        r = -Real(2.07216E-1);
+        s = -Real(4.45532E-3);
+      }
+    }
+    return p+q*a[0]+r*a[1]+s*a[0]*a[1];
+  }
+
+  #ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+  /*\
+   *  Starting point for the scaled cubic of class iclass by bilinear
+   *  interpolation of the roots tabulated on the grid of the two free
+   *  coefficients. Return false in the cells where the tabulated root
+   *  jumps to another root of the cubic, the fits are used there.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  cubicTableGuess( indexType iclass, Real const a[3], Real & x ) {
+    Real const maxJump = Real(0.25);
+    Real u, v;
+    switch ( iclass ) {
+      case 1: case 2: u = a[1]; v = a[2]; break;
+      case 3: case 4: u = a[0]; v = a[2]; break;
+      default:        u = a[0]; v = a[1]; break;
+    }
+    if ( !( abs(u) <= 1 && abs(v) <= 1 ) ) return false; // also NaN
+    indexType const n  = cubicTableSize;
+    Real            fu = (u+1)*Real(n)/2;
+    Real            fv = (v+1)*Real(n)/2;
+    indexType       i  = std::min( indexType(fu), n-1 );
+    indexType       j  = std::min( indexType(fv), n-1 );
+    double const *  T  = cubicTableData() + ((iclass-1)*(n+1)+i)*(n+1)+j;
+    Real t00 = Real(T[0]), t01 = Real(T[1]);
+    Real t10 = Real(T[n+1]), t11 = Real(T[n+2]);
+    Real tmin = std::min( std::min(t00,t01), std::min(t10,t11) );
+    Real tmax = std::max( std::max(t00,t01), std::max(t10,t11) );
+    if ( tmax-tmin > maxJump ) return false;
+    Real s = fu-i;
+    Real t = fv-j;
+    x = (1-s)*((1-t)*t00+t*t01) + s*((1-t)*t10+t*t11);
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_TABLE, 1 );
+    return true;
+  }
+  #endif
+
+  /*\
+   *  Starting point of the Newton iterations for the scaled cubic of
+   *  class iclass (see cubicNewtonSetup): the tabulated root when compiled
+   *  with POLYNOMIAL_ROOTS_CUBIC_TABLE, otherwise the bilinear fits.
+  \*/
+
+  template <typename Real>
+  inline
+  Real
+  cubicClassGuess( indexType iclass, Real const a[3] ) {
+    #ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+    Real x;
+    if ( cubicTableGuess( iclass, a, x ) ) return x;
+    #endif
+    switch ( iclass ) {
+      case 1: return guess1(a);
+      case 2: return guess2(a);
+      case 3: return guess3(a);
+      case 4: return guess4(a);
+      case 5: return guess5(a);
+    }
+    return guess6(a);
+  }
+
+  /*
+  ||   _   _               _              ____  _               _   _
+  ||  | \ | | _____      _| |_ ___  _ __ | __ )(_)___  ___  ___| |_(_) ___  _ __
+  ||  |  \| |/ _ \ \ /\ / / __/ _ \| '_ \|  _ \| / __|/ _ \/ __| __| |/ _ \| '_ \
+  ||  | |\  |  __/\ V  V /| || (_) | | | | |_) | \__ \  __/ (__| |_| | (_) | | | |
+  ||  |_| \_|\___| \_/\_/  \__\___/|_| |_|____/|_|___/\___|\___|\__|_|\___/|_| |_|
+  */
+
+  // x^3 + a * x^2 + b * x + c
+  template <typename Real>
+  inline
+  indexType
+  NewtonBisection(
+    Real        a,
+    Real        b,
+    Real        c,
+    Real      & x
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    Real p, dp;
+    evalMonicCubic( x, a, b, c, p, dp );
+    Real t = p; // save p(x) for sign comparison
+    x -= p/dp; // 1st improved root
+
+    indexType iter      = 1;
+    indexType oscillate = 0;
+    bool      bisection = false;
+    bool      converged = false;
+    Real      s(0), u(0); // to mute warning
+    while ( ! (converged||bisection) && iter < maxNewtonIter ) {
+      ++iter;
+      evalMonicCubic( x, a, b, c, p, dp );
+      if ( p*t < 0 ) { // does Newton start oscillating ?
+        if ( p < 0 ) {
+          ++oscillate; // increment oscillation counter
+          s = x;       // save lower bisection bound
+        } else {
+          u = x; // save upper bisection bound
+        }
+        t = p; // save current p(x)
+      }
+      dp = p/dp; // Newton correction
+      x -= dp;   // new Newton root
+      bisection = oscillate > 2; // activate bisection
+      converged = abs(dp) <= abs(x) * machepsi; // Newton convergence indicator
+    }
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_NEWTON_ITER, iter );
+    if ( bisection ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_BISECTION, 1 );
+      t = u - s; // initial bisection interval
+      while ( abs(t) > abs(x) * machepsi ) { // bisection iterates
+        ++iter;
+        POLYNOMIAL_ROOTS_COUNT( CUBIC_BISECTION_ITER, 1 );
+        p = evalMonicCubic( x, a, b, c );
+        if ( p < 0 ) s = x;
+        else         u = x; // keep bracket on root
+        t = (u-s)/2; // new bisection interval
+        x = s + t;   // new bisection root
+      }
+    }
+    return iter;
+  }
+
+  /*\
+   *  Stopping rule of the warm started iterations: with convergence of
+   *  the given order the next correction is about |dx|*q^order, where
+   *  q = |dx/dx0| is the contraction of the last two corrections, and the
+   *  iterations stop when it is below the rounding of x. Before the
+   *  second correction (dx0 = 0) only dx = 0 stops.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  warmConverged( Real dx, Real dx0, Real x, indexType order ) {
+    Real q    = abs(dx) < abs(dx0) ? abs(dx/dx0) : 1;
+    Real next = abs(dx);
+    for ( indexType k = 0; k < order; ++k ) next *= q;
+    return next <= abs(x) * machineEpsilon<Real>();
+  }
+
+  /*\
+   *  Halley iterations on x^3 + a*x^2 + b*x + c from the root x of a
+   *  near cubic. Return false if they do not converge in a few steps,
+   *  the caller then solves the cubic from scratch.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  NewtonWarmStart(
+    Real        a,
+    Real        b,
+    Real        c,
+    Real      & x,
+    indexType & iter
+  ) {
+    Real      dx0 = 0;
+    bool      converged = false;
+    for ( iter = 0; !converged && iter < 8; ) {
+      ++iter;
+      Real p, dp, ddp;
+      evalMonicCubic( x, a, b, c, p, dp, ddp );
+      if ( isZero(p) ) { converged = true; break; }
+      Real dx = (p*dp)/(dp*dp-p*ddp/2); // Halley correction
+      x        -= dx;
+      converged = warmConverged( dx, dx0, x, 3 );
+      dx0       = dx;
+    }
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_NEWTON_ITER, iter );
+    return converged; // NaN or infinite corrections never converge
+  }
+
+  /*\
+   *  Scale the monic cubic x^3 + aa*x^2 + bb*x + cc so that the largest
+   *  of |aa|, |bb|^(1/2), |cc|^(1/3) is 1: the roots of
+   *  x^3 + na*x^2 + nb*x + nc times scale are the roots of the cubic,
+   *  i_case is the index of the largest coefficient (0 for cc).
+  \*/
+
+  template <typename Real>
+  inline
+  void
+  scaleCubicMonicPolynomial(
+    Real        aa,
+    Real        bb,
+    Real        cc,
+    Real      & na,
+    Real      & nb,
+    Real      & nc,
+    indexType & i_case,
+    Real      & scale
+  ) {
+    Real absa = abs(aa);
+    Real absb = sqrt(abs(bb));
+    Real absc = cbrt(abs(cc));
+
+    i_case = 0; // c MAX
+    if ( absa < absb ) {
+      if ( absc < absb ) i_case = 1; // |a| < |b| and |b| < |c| --> b MAX
+      // |a| < |b| <= |c| --> c MAX
+    } else {
+      if ( absc < absa ) i_case = 2; // |b| <= |a| and |c| < |a| --> a MAX
+      // |b| <= |a| < |c| --> c MAX
+    }
+
+    scale = 0;
+    switch ( i_case ) {
+    case 0:
+      scale = absc;
+      na    = aa/absc;
+      nb    = (bb/absc)/absc;
+      nc    = cc > 0 ? 1 : -1;
+      break;
+    case 1:
+      scale = absb;
+      na    = aa/absb;
+      nb    = bb > 0 ? 1 : -1;
+      nc    = ((cc/absb)/absb)/absb;
+      break;
+    case 2:
+      scale = absa;
+      na    = aa > 0 ? 1 : -1;
+      nb    = (bb/absa)/absa;
+      nc    = ((cc/absa)/absa)/absa;
+      break;
+    }
+  }
+
+  /*\
+   *  Scale the monic quartic x^4 + A*x^3 + B*x^2 + C*x + D so that the
+   *  largest of |A|, |B|^(1/2), |C|^(1/3), |D|^(1/4) is 1: the roots of
+   *  x^4 + AS*x^3 + BS*x^2 + CS*x + DS times scale are the roots of the
+   *  quartic, i_case is the index of the largest coefficient (0 for D).
+  \*/
+
+  template <typename Real>
+  inline
+  void
+  scaleQuarticMonicPolynomial(
+    Real        A,
+    Real        B,
+    Real        C,
+    Real        D,
+    Real      & AS,
+    Real      & BS,
+    Real      & CS,
+    Real      & DS,
+    indexType & i_case,
+    Real      & scale
+  ) {
+
+    Real a = abs(A);
+    Real b = sqrt(abs(B));
+    Real c = cbrt(abs(C));
+    Real d = sqrt(sqrt(abs(D)));
+
+    if ( a < b ) {
+      if ( b < c ) {
+        if ( c < d ) i_case = 0; // a < b < c < d        --> d MAX
+        else         i_case = 1; // a < b < c and d <= c --> c MAX
+      } else {
+        if ( b < d ) i_case = 0; // a < b and c <= b < d --> d MAX
+        else         i_case = 2; // a < b and c <= b and d <= b --> b MAX
+      }
+    } else {
+      if ( a < c ) {
+        if ( c < d ) i_case = 0; // b <= a < c < d        --> d MAX
+        else         i_case = 1; // b <= a < c and d <= c --> c MAX
+      } else {
+        if ( a < d ) i_case = 0; // b <= a and c <= a and a < d --> d MAX
+        else         i_case = 3; // b <= a and c <= a and d <= a --> a MAX
+      }
+    }
+
+    switch ( i_case ) {
+      case 0:
+        scale = d;
+        AS    = A/d;
+        BS    = (B/d)/d;
+        CS    = ((C/d)/d)/d;
+        DS    = D > 0 ? 1 : -1;
+      break;
+      case 1:
+        scale = c;
+        AS    = A/c;
+        BS    = (B/c)/c;
+        CS    = C > 0 ? 1 : -1;
+        DS    = (((D/c)/c)/c)/c;
+      break;
+      case 2:
+        scale = b;
+        AS    = A/b;
+        BS    = B > 0 ? 1 : -1;
+        CS    = ((C/b)/b)/b;
+        DS    = (((D/b)/b)/b)/b;
+      break;
+      case 3:
+        scale = a;
+        AS    = A > 0 ? 1 : -1;
+        BS    = (B/a)/a;
+        CS    = ((C/a)/a)/a;
+        DS    = (((D/a)/a)/a)/a;
+      break;
+    }
+  }
+
+  /*\
+   *  Scale the monic cubic x^3 + aa*x^2 + bb*x + cc, select the class of the
+   *  scaled polynomial and compute the starting point for Newton iterations.
+   *  Newton iterates on y^3 + na*y^2 + nb*y + nc starting from y = x,
+   *  the root of the original cubic is (y+shift)*scale.
+   *  Return false if a triple root (equal to shift*scale) is detected.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  cubicNewtonSetup(
+    Real        aa,
+    Real        bb,
+    Real        cc,
+    Real      & scale,
+    Real      & na,
+    Real      & nb,
+    Real      & nc,
+    Real      & x,
+    Real      & shift
+  ) {
+    Real const machepsi = machineEpsilon<Real>();
+    Real const third    = Real(1)/3;
+    Real const one27th  = Real(1)/27;
+    Real const two27th  = Real(2)/27;
+    /*              _
+    ||  ___ __ __ _| |___
+    || (_-</ _/ _` | / -_)
+    || /__/\__\__,_|_\___|
+    */
+    // scale Cubic Monic Polynomial
+    Real      a[3];
+    indexType i_case;
+    scaleCubicMonicPolynomial( aa, bb, cc, a[2], a[1], a[0], i_case, scale );
+
+    /*
+    ||   __ _ _  _ ___ ______
+    ||  / _` | || / -_|_-<_-<
+    ||  \__, |\_,_\___/__/__/
+    ||  |___/
+    */
+    // Class1: a[0] = −1, −1 <= a[1],a[2] <= +1
+    // Class2: a[0] = +1, −1 <= a[1],a[2] <= +1
+    // Class3: a[1] = −1, −1 <= a[0],a[2] <= +1
+    // Class4: a[1] = +1, −1 <= a[0],a[2] <= +1
+    // Class5: a[2] = −1, −1 <= a[0],a[1] <= +1
+    // Class6: a[2] = +1, −1 <= a[0],a[1] <= +1
+    indexType iclass = -1;
+    switch ( i_case ) {
+      case 0: iclass = a[0] > 0 ? 2 : 1; break;
+      case 1: iclass = a[1] > 0 ? 4 : 3; break;
+      case 2: iclass = a[2] > 0 ? 6 : 5; break;
+    }
+
+    // by default iterate on the scaled polynomial
+    na    = a[2];
+    nb    = a[1];
+    nc    = a[0];
+    shift = 0;
+
+    x = cubicClassGuess( iclass, a );
+
+    Real r0, r1;
+    switch ( iclass ) {
+    case 5:
+      r0 = a[1]-third;
+      r1 = a[0]+one27th;
+      if ( abs(r0) <= machepsi && abs(r1) <= machepsi ) // check for triple root
+        { shift = third; POLYNOMIAL_ROOTS_COUNT( CUBIC_TRIPLE, 1 ); return false; }
+      if ( abs(r0) <= 0.01 && abs(r1) <= 0.01 ) {
+        // a[2] == -1
+        // y^3 + (a[1]-1/3)* y + (a[0]+a[1]/3-2/27), x = y+1/3
+        na    = 0;
+        nb    = r0;
+        nc    = a[0]+a[1]/3-two27th;
+        shift = third;
+        x    -= shift; // shift guess
+        POLYNOMIAL_ROOTS_COUNT( CUBIC_SHIFTED, 1 );
+      }
+      break;
+    case 6:
+      r0 = a[1]-third;
+      r1 = a[0]-one27th;
+      if ( abs(r0) <= machepsi && abs(r1) <= machepsi ) // check for triple root
+        { shift = -third; POLYNOMIAL_ROOTS_COUNT( CUBIC_TRIPLE, 1 ); return false; }
+      if ( abs(r0) <= 0.01 && abs(r1) <= 0.01 ) {
+        // a[2] == 1
+        // y^3 + (a[1]-1/3)* y + (a[0]-a[1]/3+2/27), x = y-1/3
+        na    = 0;
+        nb    = r0;
+        nc    = a[0]-a[1]/3+two27th;
+        shift = -third;
+        x    -= shift; // shift guess
+        POLYNOMIAL_ROOTS_COUNT( CUBIC_SHIFTED, 1 );
+      }
+      break;
+    }
+    return true;
+  }
+
+  /*\
+   *  Given the real root r2 of x^3 + aa*x^2 + bb*x + cc deflate
+   *  and compute the remaining roots.
+  \*/
+
+  template <typename Real>
+  inline
+  void
+  cubicDeflateAndSolve(
+    Real        aa,
+    Real        cc,
+    Real      & r0,
+    Real      & r1,
+    Real      & r2,
+    indexType & nrts,
+    bool      & cplx,
+    bool      & dblx
+  ) {
+    // deflate
+    // A*x^3 + B*x^2 + C*x + D = A*(x-r2)*(x^2+b1*x+b0)
+    Real b0 = -cc/r2; // -(D/A)/r2;
+    Real b1 = aa+r2; // (B/A)+r2;
+    //std::cout << "err = " << A*(b1*r2-b0)+C << '\n';
+
+    // solve quadratic polynomial
+    QuadraticT<Real> qsolve( 1, b1, b0 );
+    nrts = qsolve.numRoots()+1;
+    cplx = qsolve.complexRoots();
+    dblx = qsolve.doubleRoot();
+    r0   = qsolve.real_root0();
+    r1   = qsolve.real_root1();
+    if ( !cplx ) { // if real roots sort it!
+      if ( r1 > r2 ) std::swap(r1,r2);
+      if ( r0 > r1 ) std::swap(r0,r1);
+    }
+  }
+
+  /*\
+   *  Calculate the zeros of the cubic A*z^3 + B*z^2 + C*z + D.
+   *  Return false if the cubic is a special case not handled
+   *  by scaling and Newton iterations.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  solveCubicSpecialCases(
+    Real        A,
+    Real        B,
+    Real        C,
+    Real        D,
+    Real      & r0,
+    Real      & r1,
+    Real      & r2,
+    indexType & nrts,
+    bool      & cplx,
+    bool      & dblx
+  ) {
+    if ( isZero(A) ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_SPECIAL, 1 );
+      QuadraticT<Real> qsolve( B, C, D );
+      nrts = qsolve.numRoots();
+      cplx = qsolve.complexRoots();
+      dblx = qsolve.doubleRoot();
+      r0   = qsolve.real_root0();
+      r1   = qsolve.real_root1();
+      return true;
+    }
+    if ( isZero(D) ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_SPECIAL, 1 );
+      QuadraticT<Real> qsolve( A, B, C );
+      nrts = qsolve.numRoots()+1;
+      cplx = qsolve.complexRoots();
+      r0   = qsolve.real_root0();
+      r1   = qsolve.real_root1();
+      r2   = 0;
+      if ( !cplx ) { // reorder
+        if ( r2 < r1 ) std::swap( r1, r2 );
+        if ( r1 < r0 ) std::swap( r0, r1 );
+      }
+      return true;
+    }
+    return false;
+  }
+
+  /*\
+   *  Calculate the zeros of the cubic a*z^3 + b*z^2 + c*z + d.
+  \*/
+
+  template <typename Real>
+  inline
+  void
+  CubicT<Real>::findRoots() {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    nrts = iter = 0;
+    cplx = dblx = trpx = false;
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_SOLVES, 1 );
+    // special cases
+    if ( solveCubicSpecialCases( A, B, C, D, r0, r1, r2, nrts, cplx, dblx ) )
+      return;
+
+    // x^3 + aa * x^2 + bb * x + cc
+    valueType aa = B/A;
+    valueType bb = C/A;
+    valueType cc = D/A;
+
+    valueType scale, na, nb, nc, shift;
+    trpx = !cubicNewtonSetup( aa, bb, cc, scale, na, nb, nc, r2, shift );
+    if ( trpx ) { r0 = r1 = r2 = shift * scale; nrts = 3; return; }
+
+    /*
+    ||          _
+    ||  ___ ___| |_ _____
+    || (_-</ _ \ \ V / -_)
+    || /__/\___/_|\_/\___|
+    */
+    #ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+    // Halley from the tabulated root, then Newton-bisection if it does not
+    // converge (slow near a multiple root): from the last iterate if finite
+    valueType x0 = r2;
+    if ( !NewtonWarmStart( na, nb, nc, r2, iter ) ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_TABLE_FALLBACK, 1 );
+      if ( !( abs(r2) <= 2 ) ) r2 = x0; // the roots of the scaled cubic are in [-2,2]
+      iter += NewtonBisection( na, nb, nc, r2 );
+    }
+    #else
+    iter = NewtonBisection( na, nb, nc, r2 );
+    #endif
+    r2 += shift; // unshift solution
+
+    // scale root
+    r2 *= scale;
+
+    cubicDeflateAndSolve( aa, cc, r0, r1, r2, nrts, cplx, dblx );
+  }
+
+  /*\
+   *  Calculate the zeros of the cubic a*z^3 + b*z^2 + c*z + d starting
+   *  from the real root r2 of the previous cubic. Return false (and leave
+   *  the roots untouched) if the roots must be computed by findRoots.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  CubicT<Real>::warmRoots() {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    if ( nrts != 3 || trpx || isZero(A) || isZero(D) ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_WARM_FALLBACK, 1 );
+      return false;
+    }
+
+    // x^3 + aa * x^2 + bb * x + cc
+    valueType aa = B/A;
+    valueType bb = C/A;
+    valueType cc = D/A;
+
+    valueType x0, x1, x2 = r2;
+    indexType nr, it;
+    bool      cp, db;
+    bool ok = NewtonWarmStart( aa, bb, cc, x2, it ) && !isZero(x2);
+    if ( ok ) {
+      cubicDeflateAndSolve( aa, cc, x0, x1, x2, nr, cp, db );
+      ok = cp == cplx; // the same kind of roots
+    }
+    if ( !ok ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_WARM_FALLBACK, 1 );
+      return false;
+    }
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_SOLVES, 1 );
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_WARM, 1 );
+    r0   = x0;
+    r1   = x1;
+    r2   = x2;
+    nrts = nr;
+    cplx = cp;
+    dblx = db;
+    iter = it;
+    return true;
+  }
+
+  /*\
+   *  Real root x of the monic cubic x^3 + aa*x^2 + bb*x + cc by the closed
+   *  form on the depressed cubic t^3 + p*t + q, x = t - aa/3: the
+   *  trigonometric formula with three real roots (the largest in modulus
+   *  of the two extreme roots, or the largest root if `largest`),
+   *  Cardano's formula with one real root.
+   *  A Newton step polishes x, return false if the error estimated after
+   *  the step with the Newton error model |p''/(2p')|*dx^2 is above the
+   *  rounding of x, or if the error due to the rounding of p(x), divided
+   *  by |p'(x)|, is above 1000 roundings of x (close or multiple roots).
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  cubicClosedFormRoot( Real aa, Real bb, Real cc, Real & x, bool largest = false ) {
+    Real const twoPi3 = Real(2.0943951023931954923084289221863353L); // 2*pi/3
+    Real a3    = aa/3;
+    Real p3    = (bb - aa*a3)/3;
+    Real h     = ((2*a3*a3 - bb)*a3 + cc)/2; // q/2
+    Real delta = h*h + p3*p3*p3;
+    if ( delta < 0 ) { // three real roots, p3 < 0
+      Real sp = sqrt(-p3);
+      Real c3 = std::max( Real(-1), std::min( Real(1), h/(p3*sp) ) );
+      Real th = acos(c3)/3;
+      Real x0 = 2*sp*cos(th) - a3;
+      Real x2 = 2*sp*cos(th+twoPi3) - a3;
+      x = largest || abs(x0) >= abs(x2) ? x0 : x2;
+    } else {
+      Real s = cbrt( abs(h) + sqrt(delta) );
+      Real u = h >= 0 ? -s : s;
+      x = ( isZero(u) ? u : u - p3/u ) - a3;
+    }
+    Real const machepsi = machineEpsilon<Real>();
+    Real f, df, ddf;
+    evalMonicCubic( x, aa, bb, cc, f, df, ddf );
+    Real ax  = abs(x);
+    Real ef  = (((ax + abs(aa))*ax + abs(bb))*ax + abs(cc)) * machepsi; // rounding of p(x)
+    Real dx  = isZero(f) ? f : f/df;
+    x -= dx;
+    return ef <= 1000 * abs(x*df) * machepsi &&
+           dx*dx*abs(ddf) <= 2 * abs(x*df) * machepsi; // false for NaN
+  }
+
+  /*\
+   *  Calculate the zeros of the cubic a*z^3 + b*z^2 + c*z + d from the
+   *  closed form root. Return false (and leave the roots untouched) if the
+   *  roots must be computed by findRoots.
+  \*/
+
+  template <typename Real>
+  inline
+  bool
+  CubicT<Real>::closedFormRoots() {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    if ( isZero(A) || isZero(D) ) return false; // special cases of findRoots
+
+    // x^3 + aa * x^2 + bb * x + cc
+    valueType aa = B/A;
+    valueType bb = C/A;
+    valueType cc = D/A;
+
+    valueType x;
+    if ( !cubicClosedFormRoot( aa, bb, cc, x ) || isZero(x) ) {
+      POLYNOMIAL_ROOTS_COUNT( CUBIC_CLOSED_FORM_FALLBACK, 1 );
+      return false;
+    }
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_SOLVES, 1 );
+    POLYNOMIAL_ROOTS_COUNT( CUBIC_CLOSED_FORM, 1 );
+    cplx = dblx = trpx = false;
+    iter = 1;
+    r2   = x;
+    cubicDeflateAndSolve( aa, cc, r0, r1, r2, nrts, cplx, dblx );
+    return true;
+  }
+
+  template <typename Real>
+  inline
+  void
+  CubicT<Real>::info( std::ostream & s ) const {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    s << "\npoly a=" << A << " b=" << B << " c=" << C << " d=" << D
+      << "\nn. roots = " << nrts
+      << "\ncomplex  = " << (cplx?"YES":"NO")
+      << "\ntriple   = " << (trpx?"YES":"NO")
+      << "\ndouble   = " << (dblx?"YES":"NO");
+    if ( cplx ) {
+      s << "\nx0 = (" << r0 << "," <<  r1 << ')'
+        << "\nx1 = (" << r0 << "," << -r1 << ')';
+      if ( nrts > 2 ) s << "\nx3 = " << r2;
+    } else {
+      if ( nrts > 0 ) s << "\nx0 = " << r0;
+      if ( nrts > 1 ) s << "\nx1 = " << r1;
+      if ( nrts > 2 ) s << "\nx2 = " << r2;
+    }
+    s << '\n';
+  }
+
+  template <typename Real>
+  inline
+  bool
+  CubicT<Real>::check( std::ostream & s ) const {
+    valueType const & A = ABCD[0];
+    valueType const & B = ABCD[1];
+    valueType const & C = ABCD[2];
+    valueType const & D = ABCD[3];
+    valueType const machepsi = machineEpsilon<valueType>();
+    bool ok = true;
+    valueType epsi = 10 * ( abs(A) +
+                            abs(B) +
+                            abs(C) +
+                            abs(D) ) * machepsi;
+    if ( cplx ) {
+      valueType z0 = abs(eval( root0() ));
+      valueType z1 = abs(eval( root1() ));
+      valueType z2 = abs(eval( root2() ));
+      valueType zr = eval( real_root0() );
+      s << "|p(r0)| = " << z0
+        << "\n|p(r1)| = " << z1
+        << "\n|p(r2)| = " << z2
+        << "\np(real_part(r0)) = " << zr
+        << '\n';
+      ok = z0 < epsi && z1 < epsi && z2 < epsi;
+    } else if ( nrts == 1 ) {
+      valueType z0 = eval( real_root0() );
+      s << "p(r0) = " << z0  << '\n';
+      ok = abs(z0) < epsi;
+    } else if ( nrts == 2 ) {
+      valueType z0 = abs(eval( root0() ));
+      valueType z1 = abs(eval( root1() ));
+      s << "p(r0) = " << z0
+        << "\np(r1) = " << z1
+        << '\n';
+      ok = abs(z0) < epsi && abs(z1) < epsi;
+    } else if ( nrts == 3 ) {
+      if ( cplx ) {
+        valueType z0 = abs(eval( root0() ));
+        valueType z1 = abs(eval( root1() ));
+        valueType z2 = abs(eval( root2() ));
+        s << "|p(r0)| = " << z0
+          << "\n|p(r1)| = " << z1
+          << "\n|p(r2)| = " << z2
+          << '\n';
+        ok = z0 < epsi && z1 < epsi && z2 < epsi;
+      } else {
+        valueType z0 = eval( real_root0() );
+        valueType z1 = eval( real_root1() );
+        valueType z2 = eval( real_root2() );
+        s << "p(r0) = " << z0
+          << "\np(r1) = " << z1
+          << "\np(r2) = " << z2
+          << '\n';
+        ok = abs(z0) < epsi && abs(z1) < epsi && abs(z2) < epsi;
+      }
+    }
+    return ok;
+  }
+
+  template <typename Real>
+  inline
+  bool
+  solveCubicInterval(
+    Real   A,
+    Real   B,
+    Real   C,
+    Real   D,
+    Real   lo,
+    Real   hi,
+    Real & x
+  ) {
+    Real const p[] = { A, B, C, D };
+    Real       st[2] = { 0, 0 };
+    indexType  nst = 0;
+    if ( isZero(A) ) { // at most quadratic
+      if ( !isZero(B) ) {
+        st[nst++] = -C/(2*B);
+        return firstRootInInterval( p+1, 2, st, nst, lo, hi, x );
+      }
+      if ( isZero(C) ) return false;
+      return firstRootInInterval( p+2, 1, st, nst, lo, hi, x );
+    }
+    // stationary points, roots of 3*A*x^2 + 2*B*x + C
+    QuadraticT<Real> dsolve( 3*A, 2*B, C );
+    nst = dsolve.getRealRoots( st );
+    return firstRootInInterval( p, 3, st, nst, lo, hi, x );
+  }
+
+}
+
+#endif
+
+// EOF: PolynomialRoots-inline.hh
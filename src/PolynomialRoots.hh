@@ -22,8 +22,14 @@
 
 #include <cmath>
 #include <cfloat>
+#include <cstddef>
 #include <complex>
 #include <iostream>
+#include <vector>
+
+#ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+#include <quadmath.h>
+#endif
 
 /*!
 
@@ -104,57 +110,381 @@ namespace PolynomialRoots {
   typedef std::complex<valueType> complexType;
 
   //! check if cloating point number `x` is zero
-  static
+  template <typename Real>
   inline
   bool
-  isZero( valueType x )
+  isZero( Real x )
   { return FP_ZERO == std::fpclassify(x); }
 
   //! check if cloating point number `x` is finite
-  static
+  template <typename Real>
   inline
   bool
-  isInfinite( valueType x )
+  isInfinite( Real x )
   { return FP_INFINITE == std::fpclassify(x); }
 
   //! check if cloating point number `x` is Not A Number
-  static
+  template <typename Real>
   inline
   bool
-  isNaN( valueType x )
+  isNaN( Real x )
   { return FP_NAN == std::fpclassify(x); }
 
   //! check if cloating point number `x` is regural (i.e. finite and not NaN)
-  static
+  template <typename Real>
   inline
   bool
-  isRegular( valueType x )
+  isRegular( Real x )
   { return !( FP_INFINITE == std::fpclassify(x) ||
               FP_NAN      == std::fpclassify(x) ); }
 
+  #ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+  // std::fpclassify is not available for quad precision
+  inline bool isZero( __float128 x )     { return x == 0; }
+  inline bool isInfinite( __float128 x ) { return isinfq(x) != 0; }
+  inline bool isNaN( __float128 x )      { return isnanq(x) != 0; }
+  inline bool isRegular( __float128 x )  { return finiteq(x) != 0; }
+
+  //! print a quad precision number using the precision of the stream
+  inline
+  std::ostream &
+  operator << ( std::ostream & s, __float128 x ) {
+    char buffer[128];
+    quadmath_snprintf( buffer, sizeof(buffer), "%.*Qg", int(s.precision()), x );
+    return s << buffer;
+  }
+  #endif
+
   //! evaluate real polynomial
-  valueType
+  template <typename Real>
+  Real
+  evalPoly(
+    Real const op[],
+    indexType  Degree,
+    Real       x
+  );
+
+  //! evaluate real polynomial at `n` points
+  /*!
+   * Compute `res[i] = evalPoly(op,Degree,x[i])` for `i = 0,...,n-1`.
+   * The evaluation is vectorized across the points, for \f$ |x|>1 \f$
+   * the polynomial is evaluated in \f$ 1/x \f$ (computed once for each
+   * point), so the results can differ from the scalar `evalPoly` in the
+   * last bits.
+   */
+  template <typename Real>
+  void
   evalPoly(
-    valueType const op[],
-    indexType       Degree,
-    valueType       x
+    Real const op[],
+    indexType  Degree,
+    Real const x[],
+    indexType  n,
+    Real       res[]
   );
 
   //! evaluate real polynomial with complex value
-  std::complex<valueType>
+  template <typename Real>
+  std::complex<Real>
+  evalPolyC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x
+  );
+
+  //! evaluate real polynomial at `n` complex points
+  /*!
+   * Compute `pr[i] + I*pi[i] = evalPolyC(op,Degree,complex(xr[i],xi[i]))`
+   * for `i = 0,...,n-1`, the points and the values are split in real and
+   * imaginary parts. As for the batch `evalPoly` the evaluation is
+   * vectorized across the points and for \f$ |x|>1 \f$ it uses
+   * \f$ 1/x \f$ computed once for each point, so the results can differ
+   * from `evalPolyC` in the last bits.
+   */
+  template <typename Real>
+  void
   evalPolyC(
-    valueType const                 op[],
-    indexType                       Degree,
-    std::complex<valueType> const & x
+    Real const op[],
+    indexType  Degree,
+    Real const xr[],
+    Real const xi[],
+    indexType  n,
+    Real       pr[],
+    Real       pi[]
+  );
+
+  //! evaluate real polynomial with the compensated Horner scheme
+  /*!
+   * The rounding errors of the Horner recurrence are computed exactly
+   * by `TwoProduct` and `TwoSum` and accumulated in a second recurrence,
+   * the result is as accurate as `evalPoly` in twice the precision and
+   * then rounded to `Real`. Useful near multiple or clustered roots,
+   * where `evalPoly` returns only rounding noise.
+   */
+  template <typename Real>
+  Real
+  compHorner(
+    Real const op[],
+    indexType  Degree,
+    Real       x
+  );
+
+  //! evaluate real polynomial with complex value with the compensated Horner scheme
+  template <typename Real>
+  std::complex<Real>
+  compHornerC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x
+  );
+
+  //! refine a real root with Euler steps evaluated by the compensated Horner scheme
+  /*!
+   * Each step adds to `x` the root `d` of smallest modulus of the local
+   * Taylor quadratic \f$ p(x) + p'(x) d + p''(x) d^2/2 \f$ (Euler method),
+   * a Newton step when the quadratic has no real root. The iterations stop
+   * when the correction is at the level of the rounding of `x` or when the
+   * residual no longer decreases, a step that increases the residual is
+   * discarded. Multiple roots converge linearly, so `maxIter` allows some
+   * tens of steps.
+   *
+   * \param[in] op      coefficients, `op[0]` is the leading one
+   * \param[in] Degree  degree of the polynomial
+   * \param[in] x       approximation of the root
+   * \param[in] maxIter maximum number of Euler steps
+   * \return the refined root
+   */
+  template <typename Real>
+  Real
+  polishRoot(
+    Real const op[],
+    indexType  Degree,
+    Real       x,
+    indexType  maxIter = 50
+  );
+
+  //! refine a complex root with the Euler steps of `polishRoot` in complex arithmetic
+  /*!
+   * In complex arithmetic the Taylor quadratic always has a root, so there
+   * is no Newton fallback.
+   */
+  template <typename Real>
+  std::complex<Real>
+  polishRootC(
+    Real const                 op[],
+    indexType                  Degree,
+    std::complex<Real> const & x,
+    indexType                  maxIter = 50
   );
 
   //! find roots of a generic polinomial using Jenkins-Traub method
+  /*!
+   * Return 0 on success, -1 if `Degree < 1`, -2 if the leading coefficient
+   * is zero or the iteration does not converge. The working memory is
+   * allocated at each call, use a `JenkinsTraubWorkspace` for repeated solves.
+   */
+  template <typename Real>
+  int
+  roots(
+    Real const op[],
+    indexType  Degree,
+    Real       zeror[],
+    Real       zeroi[]
+  );
+
+  //! working memory for the Jenkins-Traub method
+  /*!
+   * Preallocated buffers for polynomials up to degree `maxDegree`.
+   * Repeated calls of `roots` with the same workspace do not allocate
+   * memory and use a bounded amount of stack. A workspace must not be
+   * shared between threads.
+   */
+  template <typename Real>
+  class JenkinsTraubWorkspaceT {
+    std::vector<Real> buffer;
+    indexType         maxDegree;
+
+  public:
+
+    //! number of buffers of size `maxDegree+1` used by the solver
+    static indexType const numBuffers = 7;
+
+    explicit
+    JenkinsTraubWorkspaceT( indexType _maxDegree = 0 )
+    : maxDegree(0)
+    { allocate( _maxDegree ); }
+
+    //! resize the buffers for polynomials up to degree `_maxDegree`
+    void
+    allocate( indexType _maxDegree ) {
+      maxDegree = _maxDegree > 0 ? _maxDegree : 0;
+      buffer.resize( numBuffers*(maxDegree+1) );
+    }
+
+    //! maximum degree of the polynomials that can be solved
+    indexType getMaxDegree() const { return maxDegree; }
+
+    //! pointer to the `i`-th buffer of `maxDegree+1` elements
+    Real * getBuffer( indexType i ) { return &buffer.front() + i*(maxDegree+1); }
+
+  };
+
+  typedef JenkinsTraubWorkspaceT<valueType> JenkinsTraubWorkspace; //!< workspace in double precision
+
+  //! find roots of a generic polinomial using Jenkins-Traub method and a preallocated workspace
+  /*!
+   * Same as `roots( op, Degree, zeror, zeroi )` but no memory is allocated,
+   * return -3 if `Degree` exceeds the maximum degree of the workspace.
+   */
+  template <typename Real>
   int
   roots(
-    valueType const op[],
-    indexType       Degree,
-    valueType       zeror[],
-    valueType       zeroi[]
+    JenkinsTraubWorkspaceT<Real> & work,
+    Real const                     op[],
+    indexType                      Degree,
+    Real                           zeror[],
+    Real                           zeroi[]
+  );
+
+  //! refine the roots computed by `roots` on the original polynomial
+  /*!
+   * The roots of `roots` are computed on the successively deflated
+   * polynomial and the last ones carry the errors of the deflation.
+   * Each root `(zeror[i],zeroi[i])` is refined by Newton steps on `op`
+   * with \f$ p(x) \f$ evaluated by the compensated Horner scheme
+   * (see `compHornerC`). The roots are polished together, vectorized
+   * across the roots as the batch `evalPolyC`. The iteration of a root
+   * stops when a step does not decrease the residual (the step is
+   * discarded) or the correction is at the level of the rounding.
+   * Pairs of conjugate roots remain conjugate.
+   *
+   * \param[in]    op      coefficients, `op[0]` is the leading one
+   * \param[in]    Degree  degree of the polynomial and number of roots
+   * \param[inout] zeror   real part of the roots
+   * \param[inout] zeroi   imaginary part of the roots
+   * \param[in]    maxIter maximum number of Newton steps
+   * \return the number of roots whose iteration stopped within `maxIter`
+   */
+  template <typename Real>
+  indexType
+  polishRoots(
+    Real const op[],
+    indexType  Degree,
+    Real       zeror[],
+    Real       zeroi[],
+    indexType  maxIter = 20
+  );
+
+  //! roots of \f$ p(x) + k q(x) \f$ for a sweep of the parameter `k` (root locus)
+  /*!
+   * The roots are tracked from each gain `k[j-1]` to the next by
+   * predictor-corrector steps: the predictor moves each root along the
+   * tangent \f$ dz/dk = -q(z)/(p'(z)+k q'(z)) \f$, the corrector are Newton
+   * steps on \f$ p(x) + k q(x) \f$. A step is rejected and halved if the
+   * corrections do not converge or move a root towards another one, and
+   * doubled after an accepted step. The roots are computed from scratch
+   * (as by `solveBatchParallel`: `Quadratic`, `Cubic`, `Quartic` or the
+   * Jenkins-Traub method) at the first gain, when two roots of a real or
+   * conjugate pair collide (a pair of real roots turns complex or vice
+   * versa) and when the step becomes shorter than 1/64 of the distance
+   * between the gains; the new roots are matched to the tracked ones so
+   * that the loci stay continuous.
+   *
+   * The gains are in any order, the cost of the tracking grows with the
+   * distance between consecutive gains. The polynomial must have degree
+   * `n = max(degP,degQ)` for all the gains.
+   *
+   * \param[in]  p     coefficients of \f$ p(x) \f$, `p[0]` is the leading one
+   * \param[in]  degP  degree of \f$ p(x) \f$
+   * \param[in]  q     coefficients of \f$ q(x) \f$, `q[0]` is the leading one
+   * \param[in]  degQ  degree of \f$ q(x) \f$
+   * \param[in]  k     the gains
+   * \param[in]  nk    number of gains
+   * \param[out] zeror real part of the roots, `zeror[j*n+i]` is the i-th root for `k[j]`
+   * \param[out] zeroi imaginary part of the roots
+   * \param[out] info  0 if the roots for `k[j]` are tracked, 1 if computed from
+   *                   scratch, < 0 as returned by `roots` (the roots are set to 0)
+   * \return the number of gains whose roots are computed from scratch
+   */
+  template <typename Real>
+  indexType
+  rootLocus(
+    Real const p[],
+    indexType  degP,
+    Real const q[],
+    indexType  degQ,
+    Real const k[],
+    indexType  nk,
+    Real       zeror[],
+    Real       zeroi[],
+    indexType  info[]
+  );
+
+  //! Sturm sequence of a real polynomial, counts the real roots in an interval
+  /*!
+   * `setup` computes the sequence \f$ p_0 = p \f$, \f$ p_1 = p' \f$,
+   * \f$ p_{k+1} = -\mathrm{rem}(p_{k-1},p_k) \f$, the polynomials after
+   * \f$ p \f$ scaled so that their largest coefficient is 1; a remainder
+   * coefficient below the rounding of the division is set to zero, so that
+   * the sequence stops at the greatest common divisor of \f$ p \f$ and
+   * \f$ p' \f$ also with multiple roots. The number of distinct real roots
+   * in \f$ (a,b] \f$ is the difference of the sign changes of the sequence
+   * at `a` and at `b`, the polynomials are evaluated by `evalPoly`.
+   *
+   * Before evaluating the sequence `countRoots` checks whether
+   * \f$ |p(a)|+|p(b)| \f$ is larger than \f$ (b-a) \f$ times a bound of
+   * \f$ |p'| \f$ on the interval, then \f$ p \f$ has no roots in it:
+   * the test costs three evaluations of \f$ p \f$ and rejects most of
+   * the short intervals far from the roots.
+   */
+  template <typename Real>
+  class SturmT {
+  public:
+    typedef Real valueType;
+
+  private:
+    std::vector<valueType> seq;    // the polynomials of the sequence, leading coefficient first
+    std::vector<indexType> degree; // degree of each polynomial of the sequence
+
+  public:
+
+    SturmT() {}
+    SturmT( valueType const op[], indexType Degree ) { setup( op, Degree ); }
+
+    //! compute the Sturm sequence of the polynomial `op` (`op[0]` is the leading coefficient)
+    void setup( valueType const op[], indexType Degree );
+
+    //! number of polynomials of the sequence
+    indexType length() const { return indexType(degree.size()); }
+
+    //! number of sign changes of the sequence at `x` (zeros are skipped)
+    indexType signChanges( valueType x ) const;
+
+    //! number of distinct real roots in \f$ (a,b] \f$, 0 if \f$ b \leq a \f$
+    indexType countRoots( valueType a, valueType b ) const;
+
+    //! number of distinct real roots
+    indexType countRealRoots() const;
+  };
+
+  typedef SturmT<valueType> Sturm; //!< Sturm sequence in double precision
+
+  //! number of distinct real roots of a polynomial in \f$ (a,b] \f$
+  /*!
+   * As `SturmT::countRoots`, the Sturm sequence is computed only when the
+   * bound of \f$ |p'| \f$ does not exclude the roots from the interval.
+   *
+   * \param[in] op     coefficients of the polynomial, `op[0]` is the leading one
+   * \param[in] Degree degree of the polynomial
+   * \param[in] a,b    the interval
+   * \return the number of distinct real roots in \f$ (a,b] \f$
+   */
+  template <typename Real>
+  indexType
+  countRealRoots(
+    Real const op[],
+    indexType  Degree,
+    Real       a,
+    Real       b
   );
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -167,8 +497,16 @@ namespace PolynomialRoots {
    |
    |  A * x^2 + B * x + C
   \*/
-  //! Quadratic polynomial class
-  class Quadratic {
+  //! Quadratic polynomial class, `Real` is the floating point type used
+  template <typename Real>
+  class QuadraticT {
+  public:
+
+    typedef Real               valueType;
+    typedef std::complex<Real> complexType;
+
+  private:
+
     valueType ABC[3];
     valueType r0, r1;
     indexType nrts;
@@ -179,8 +517,8 @@ namespace PolynomialRoots {
 
   public:
 
-    Quadratic() : nrts(0), cplx(false), dblx(false) {}
-    Quadratic( valueType _a, valueType _b, valueType _c )
+    QuadraticT() : nrts(0), cplx(false), dblx(false) {}
+    QuadraticT( valueType _a, valueType _b, valueType _c )
     : nrts(0), cplx(false), dblx(false) {
       valueType & A = ABC[0];
       valueType & B = ABC[1];
@@ -302,6 +640,44 @@ namespace PolynomialRoots {
 
   };
 
+  typedef QuadraticT<valueType> Quadratic; //!< quadratic polynomial in double precision
+
+  //! solve a batch of quadratic polynomials stored as structure of arrays
+  /*!
+   * Compute the roots of \f$ A_i x^2 + B_i x + C_i \f$ for
+   * \f$ i=0,1,\ldots,n-1 \f$. All the cases of `Quadratic::findRoots`
+   * (including the discriminant computed avoiding overflow) are evaluated
+   * for every polynomial and the result is selected without branches, so
+   * that the compiler can vectorize the loop. The roots of the i-th
+   * polynomial are the same computed by class `Quadratic` and are stored
+   * in `r0[i]`, `r1[i]` with the same encoding: if `cplx[i]` is true then
+   * `(r0[i],r1[i])` are real and imaginary part of the complex conjugate
+   * roots.
+   *
+   * \param[in]  n    number of polynomials
+   * \param[in]  A    coefficients of \f$ x^2 \f$
+   * \param[in]  B    coefficients of \f$ x   \f$
+   * \param[in]  C    coefficients of \f$ x^0 \f$
+   * \param[out] r0   first root (or real part of complex roots)
+   * \param[out] r1   second root (or imaginary part of complex roots)
+   * \param[out] nrts number of roots
+   * \param[out] cplx true if there are complex roots
+   * \param[out] dblx true if there is a double root
+   */
+  template <typename Real>
+  void
+  solveQuadraticBatch(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real            r0[],
+    Real            r1[],
+    indexType       nrts[],
+    bool            cplx[],
+    bool            dblx[]
+  );
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   /*\
    |    ____      _     _
@@ -312,8 +688,16 @@ namespace PolynomialRoots {
    |
    |  A * x^3 + B * x^2 + C * x + D
   \*/
-  //! Cubic polynomial class
-  class Cubic {
+  //! Cubic polynomial class, `Real` is the floating point type used
+  template <typename Real>
+  class CubicT {
+  public:
+
+    typedef Real               valueType;
+    typedef std::complex<Real> complexType;
+
+  private:
+
     valueType ABCD[4];
     valueType r0, r1, r2;
     indexType nrts, iter;
@@ -322,11 +706,13 @@ namespace PolynomialRoots {
     bool      trpx; // triple root
 
     void findRoots();
+    bool warmRoots();
+    bool closedFormRoots();
 
   public:
 
-    Cubic() : nrts(0), iter(0), cplx(false), trpx(false) {}
-    Cubic( valueType _a, valueType _b, valueType _c, valueType _d )
+    CubicT() : nrts(0), iter(0), cplx(false), trpx(false) {}
+    CubicT( valueType _a, valueType _b, valueType _c, valueType _d )
     : nrts(0), iter(0), cplx(false), trpx(false) {
       valueType & A = ABCD[0];
       valueType & B = ABCD[1];
@@ -355,10 +741,62 @@ namespace PolynomialRoots {
       findRoots();
     }
 
+    //! compute the roots of a cubic close to the previous one (warm start)
+    /*!
+     * For a sequence of slowly changing cubics: the Newton iterations
+     * start from the real root computed by the previous `setup` or
+     * `update` instead of the starting points of `setup`. If they do not
+     * converge in a few steps or the roots change kind (a pair of real
+     * roots turns complex or vice versa) the roots are computed as by
+     * `setup`.
+     *
+     * \param[in] _a coefficient of \f$ x^3 \f$
+     * \param[in] _b coefficient of \f$ x^2 \f$
+     * \param[in] _c coefficient of \f$ x   \f$
+     * \param[in] _d coefficient of \f$ x^0 \f$
+     *
+     */
+    void
+    update( valueType _a, valueType _b, valueType _c, valueType _d ) {
+      valueType & A = ABCD[0];
+      valueType & B = ABCD[1];
+      valueType & C = ABCD[2];
+      valueType & D = ABCD[3];
+      A = _a; B = _b; C = _c; D = _d;
+      if ( !warmRoots() ) findRoots();
+    }
+
+    //! compute the roots of cubic polynomial by the closed form formulas
+    /*!
+     * A real root is computed by the trigonometric formula (three real
+     * roots) or by Cardano's formula (one real root) and polished by one
+     * Newton step, the other roots by deflation as in `setup`. When the
+     * error estimated after the Newton step, \f$ |p''/(2p')|\,dx^2 \f$,
+     * is above the rounding of the root (close or multiple roots) the roots
+     * are computed as by `setup`. The counters `CUBIC_CLOSED_FORM` and
+     * `CUBIC_CLOSED_FORM_FALLBACK` of `SolverStats` count the two cases.
+     *
+     * \param[in] _a coefficient of \f$ x^3 \f$
+     * \param[in] _b coefficient of \f$ x^2 \f$
+     * \param[in] _c coefficient of \f$ x   \f$
+     * \param[in] _d coefficient of \f$ x^0 \f$
+     *
+     */
+    void
+    setupClosedForm( valueType _a, valueType _b, valueType _c, valueType _d ) {
+      valueType & A = ABCD[0];
+      valueType & B = ABCD[1];
+      valueType & C = ABCD[2];
+      valueType & D = ABCD[3];
+      A = _a; B = _b; C = _c; D = _d;
+      if ( !closedFormRoots() ) findRoots();
+    }
+
     indexType numRoots()     const { return nrts; } //!< number of found roots
     bool      complexRoots() const { return cplx; } //!< has complex roots?
     bool      doubleRoot()   const { return dblx; } //!< has a double root?
     bool      tripleRoot()   const { return trpx; } //!< has a triple root?
+    indexType numIter()      const { return iter; } //!< number of Newton and bisection iterations
 
     //! get the real roots
     /*!
@@ -465,6 +903,99 @@ namespace PolynomialRoots {
 
   };
 
+  typedef CubicT<valueType> Cubic; //!< cubic polynomial in double precision
+
+  //! solve a batch of cubic polynomials stored as structure of arrays
+  /*!
+   * Compute the roots of \f$ A_i x^3 + B_i x^2 + C_i x + D_i \f$
+   * for \f$ i=0,1,\ldots,n-1 \f$. The Newton-bisection iterations of
+   * groups of cubics are done in lockstep so that the compiler can
+   * vectorize them. The roots of the i-th polynomial are stored in
+   * `r0[i]`, `r1[i]`, `r2[i]` with the same encoding used by class `Cubic`:
+   * if `cplx[i]` is true then `(r0[i],r1[i])` are real and imaginary
+   * part of the complex conjugate roots and `r2[i]` is the real root.
+   *
+   * \param[in]  n    number of polynomials
+   * \param[in]  A    coefficients of \f$ x^3 \f$
+   * \param[in]  B    coefficients of \f$ x^2 \f$
+   * \param[in]  C    coefficients of \f$ x   \f$
+   * \param[in]  D    coefficients of \f$ x^0 \f$
+   * \param[out] r0   first root (or real part of complex roots)
+   * \param[out] r1   second root (or imaginary part of complex roots)
+   * \param[out] r2   third root
+   * \param[out] nrts number of roots
+   * \param[out] cplx true if there are complex roots
+   * \param[out] dblx true if there is a double root
+   * \param[out] trpx true if there is a triple root
+   */
+  template <typename Real>
+  void
+  solveCubicBatch(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real const      D[],
+    Real            r0[],
+    Real            r1[],
+    Real            r2[],
+    indexType       nrts[],
+    bool            cplx[],
+    bool            dblx[],
+    bool            trpx[]
+  );
+
+  //! count the real roots of a batch of cubic polynomials in intervals
+  /*!
+   * Compute the number of distinct real roots of
+   * \f$ A_i x^3 + B_i x^2 + C_i x + D_i \f$ in \f$ (a_i,b_i] \f$ for
+   * \f$ i=0,1,\ldots,n-1 \f$ as `countRealRoots`. The sequences have at
+   * most 4 polynomials and are stored on the stack.
+   *
+   * \param[in]  n       number of polynomials
+   * \param[in]  A,B,C,D coefficients of the cubics
+   * \param[in]  a,b     the intervals
+   * \param[out] count   number of roots in the interval
+   * \return the number of polynomials with roots in their interval
+   */
+  template <typename Real>
+  indexType
+  countCubicRootsBatch(
+    indexType  n,
+    Real const A[],
+    Real const B[],
+    Real const C[],
+    Real const D[],
+    Real const a[],
+    Real const b[],
+    indexType  count[]
+  );
+
+  //! find the smallest real root of a cubic polynomial in an interval
+  /*!
+   * Find the smallest root of \f$ A x^3 + B x^2 + C x + D \f$ in
+   * \f$ [lo,hi] \f$. The stationary points split the interval in pieces
+   * where the cubic is monotone, the pieces are checked from the left and
+   * only the first root found is computed, the other roots are neither
+   * computed nor sorted.
+   *
+   * \param[in]  A,B,C,D coefficients of the cubic
+   * \param[in]  lo,hi   the interval
+   * \param[out] x       the smallest root in the interval
+   * \return false if there are no roots in the interval
+   */
+  template <typename Real>
+  bool
+  solveCubicInterval(
+    Real   A,
+    Real   B,
+    Real   C,
+    Real   D,
+    Real   lo,
+    Real   hi,
+    Real & x
+  );
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   /*\
    |    ___                   _   _
@@ -475,13 +1006,23 @@ namespace PolynomialRoots {
    |
    |  A * x^3 + B * x^2 + C * x + D
   \*/
-  //! Quartic polynomial class
-  class Quartic {
+  //! Quartic polynomial class, `Real` is the floating point type used
+  template <typename Real>
+  class QuarticT {
+  public:
+
+    typedef Real               valueType;
+    typedef std::complex<Real> complexType;
+
+  private:
+
     valueType ABCDE[5];
     valueType r0, r1, r2, r3;
     indexType iter, nreal, ncplx;
 
     void findRoots();
+    bool warmRoots();
+    bool closedFormRoots();
 
     bool cplx0() const { return ncplx > 0; }
     bool cplx1() const { return ncplx > 0; }
@@ -490,8 +1031,8 @@ namespace PolynomialRoots {
 
   public:
 
-    Quartic() : iter(0), nreal(0), ncplx(0) {}
-    Quartic(
+    QuarticT() : iter(0), nreal(0), ncplx(0) {}
+    QuarticT(
       valueType _a,
       valueType _b,
       valueType _c,
@@ -535,9 +1076,81 @@ namespace PolynomialRoots {
       findRoots();
     }
 
+    //! compute the roots of a quartic close to the previous one (warm start)
+    /*!
+     * For a sequence of slowly changing quartics: the iterations start
+     * from the roots computed by the previous `setup` or `update`. With
+     * real roots the largest one is the start of the Newton iterations on
+     * the quartic and the next one of those on the deflated cubic, the
+     * stationary points are not computed. With only complex roots the
+     * real part of a pair is the start of the iterations on the hexic and
+     * the roots are accepted if their residual is at the level of the
+     * rounding. If the iterations do not converge in a few steps or the
+     * number of real roots changes the roots are computed as by `setup`.
+     *
+     * \param[in] _a coefficient of \f$ x^4 \f$
+     * \param[in] _b coefficient of \f$ x^3 \f$
+     * \param[in] _c coefficient of \f$ x^2  \f$
+     * \param[in] _d coefficient of \f$ x   \f$
+     * \param[in] _e coefficient of \f$ x^0 \f$
+     *
+     */
+    void
+    update(
+      valueType _a,
+      valueType _b,
+      valueType _c,
+      valueType _d,
+      valueType _e
+    ) {
+      valueType & A = ABCDE[0];
+      valueType & B = ABCDE[1];
+      valueType & C = ABCDE[2];
+      valueType & D = ABCDE[3];
+      valueType & E = ABCDE[4];
+      A = _a; B = _b; C = _c; D = _d; E = _e;
+      if ( !warmRoots() ) findRoots();
+    }
+
+    //! compute the roots of quartic polynomial by the resolvent cubic
+    /*!
+     * The quartic is factored into two quadratics by the largest real
+     * root of its resolvent cubic, computed by the closed form of
+     * `CubicT::setupClosedForm`, and the quadratics are solved by
+     * `QuadraticT`. The roots are accepted if the residual of each one is
+     * at the level of the rounding, otherwise (close or multiple roots,
+     * cancellation in the factors) they are computed as by `setup`. The
+     * counters `QUARTIC_CLOSED_FORM` and `QUARTIC_CLOSED_FORM_FALLBACK`
+     * of `SolverStats` count the two cases.
+     *
+     * \param[in] _a coefficient of \f$ x^4 \f$
+     * \param[in] _b coefficient of \f$ x^3 \f$
+     * \param[in] _c coefficient of \f$ x^2  \f$
+     * \param[in] _d coefficient of \f$ x   \f$
+     * \param[in] _e coefficient of \f$ x^0 \f$
+     *
+     */
+    void
+    setupClosedForm(
+      valueType _a,
+      valueType _b,
+      valueType _c,
+      valueType _d,
+      valueType _e
+    ) {
+      valueType & A = ABCDE[0];
+      valueType & B = ABCDE[1];
+      valueType & C = ABCDE[2];
+      valueType & D = ABCDE[3];
+      valueType & E = ABCDE[4];
+      A = _a; B = _b; C = _c; D = _d; E = _e;
+      if ( !closedFormRoots() ) findRoots();
+    }
+
     indexType numRoots()        const { return nreal+ncplx; } //!< number of found roots
     indexType numRealRoots()    const { return nreal; } //!< number of real roots
     indexType numComplexRoots() const { return ncplx; } //!< number of complex roots
+    indexType numIter()         const { return iter; }  //!< number of Newton and bisection iterations
 
     //! get the real roots
     /*!
@@ -657,6 +1270,425 @@ namespace PolynomialRoots {
 
   };
 
+  typedef QuarticT<valueType> Quartic; //!< quartic polynomial in double precision
+
+  //! solve a batch of quartic polynomials stored as structure of arrays
+  /*!
+   * Compute the roots of \f$ A_i x^4 + B_i x^3 + C_i x^2 + D_i x + E_i \f$
+   * for \f$ i=0,1,\ldots,n-1 \f$ without building a `Quartic` object
+   * for each polynomial. The Newton-bisection iterations on the hexic of
+   * the quartics with only complex roots are done in lockstep, as the
+   * computation of their imaginary parts, so that the compiler can
+   * vectorize them. The results are the same of class `Quartic`.
+   * The roots of the i-th polynomial are stored in
+   * `r0[i]`, `r1[i]`, `r2[i]`, `r3[i]` with the same encoding used by
+   * class `Quartic`: if `ncplx[i] > 0` then `(r0[i],r1[i])` are real and
+   * imaginary part of the first complex conjugate pair, if `ncplx[i] > 2`
+   * then `(r2[i],r3[i])` are real and imaginary part of the second pair,
+   * the remaining values are the real roots.
+   *
+   * \param[in]  n     number of polynomials
+   * \param[in]  A     coefficients of \f$ x^4 \f$
+   * \param[in]  B     coefficients of \f$ x^3 \f$
+   * \param[in]  C     coefficients of \f$ x^2 \f$
+   * \param[in]  D     coefficients of \f$ x   \f$
+   * \param[in]  E     coefficients of \f$ x^0 \f$
+   * \param[out] r0    first root (or real part of first complex pair)
+   * \param[out] r1    second root (or imaginary part of first complex pair)
+   * \param[out] r2    third root (or real part of second complex pair)
+   * \param[out] r3    fourth root (or imaginary part of second complex pair)
+   * \param[out] nreal number of real roots
+   * \param[out] ncplx number of complex roots
+   */
+  template <typename Real>
+  void
+  solveQuarticBatch(
+    indexType       n,
+    Real const      A[],
+    Real const      B[],
+    Real const      C[],
+    Real const      D[],
+    Real const      E[],
+    Real            r0[],
+    Real            r1[],
+    Real            r2[],
+    Real            r3[],
+    indexType       nreal[],
+    indexType       ncplx[]
+  );
+
+  //! compute only the real roots of a quartic polynomial
+  /*!
+   * Compute the real roots of \f$ A x^4 + B x^3 + C x^2 + D x + E \f$
+   * with the same algorithm of class `Quartic`. When the analysis of the
+   * stationary points shows that there are no real roots the function
+   * returns immediately, the Newton iterations on the hexic and the
+   * computation of the imaginary parts are skipped.
+   *
+   * \param[in]  A,B,C,D,E coefficients of the quartic
+   * \param[out] r         the real roots (at most 4), in increasing order
+   *                       when the four roots are real
+   * \return the number of real roots
+   */
+  template <typename Real>
+  indexType
+  solveQuarticReal(
+    Real A,
+    Real B,
+    Real C,
+    Real D,
+    Real E,
+    Real r[]
+  );
+
+  //! count the real roots of a batch of quartic polynomials in intervals
+  /*!
+   * Compute the number of distinct real roots of
+   * \f$ A_i x^4 + B_i x^3 + C_i x^2 + D_i x + E_i \f$ in
+   * \f$ (a_i,b_i] \f$ for \f$ i=0,1,\ldots,n-1 \f$ as `countCubicRootsBatch`.
+   *
+   * \param[in]  n         number of polynomials
+   * \param[in]  A,B,C,D,E coefficients of the quartics
+   * \param[in]  a,b       the intervals
+   * \param[out] count     number of roots in the interval
+   * \return the number of polynomials with roots in their interval
+   */
+  template <typename Real>
+  indexType
+  countQuarticRootsBatch(
+    indexType  n,
+    Real const A[],
+    Real const B[],
+    Real const C[],
+    Real const D[],
+    Real const E[],
+    Real const a[],
+    Real const b[],
+    indexType  count[]
+  );
+
+  //! find the smallest real root of a quartic polynomial in an interval
+  /*!
+   * Find the smallest root of \f$ A x^4 + B x^3 + C x^2 + D x + E \f$
+   * in \f$ [lo,hi] \f$, e.g. the first intersection of a ray with a
+   * quartic surface. The stationary points (roots of the derivative cubic)
+   * split the interval in pieces where the quartic is monotone, the pieces
+   * are checked from the left and only the first root found is computed,
+   * no deflation is done.
+   *
+   * \param[in]  A,B,C,D,E coefficients of the quartic
+   * \param[in]  lo,hi     the interval
+   * \param[out] x         the smallest root in the interval
+   * \return false if there are no roots in the interval
+   */
+  template <typename Real>
+  bool
+  solveQuarticInterval(
+    Real   A,
+    Real   B,
+    Real   C,
+    Real   D,
+    Real   E,
+    Real   lo,
+    Real   hi,
+    Real & x
+  );
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |   ____                 _ _      _
+   |  |  _ \ __ _ _ __ __ _| | | ___| |
+   |  | |_) / _` | '__/ _` | | |/ _ \ |
+   |  |  __/ (_| | | | (_| | | |  __/ |
+   |  |_|   \__,_|_|  \__,_|_|_|\___|_|
+  \*/
+
+  //! timing of one thread of `solveBatchParallel`
+  struct ParallelBatchStats {
+    double    seconds; //!< wall time spent by the thread
+    indexType nsolved; //!< number of polynomials solved by the thread
+    indexType nstolen; //!< number of chunks stolen from other threads
+  };
+
+  //! solve a batch of polynomials of mixed degree with a pool of threads
+  /*!
+   * The polynomials are split in chunks distributed among the threads,
+   * a thread that runs out of chunks steals half of the remaining chunks
+   * of another thread. Degree 2, 3 and 4 are solved with `Quadratic`,
+   * `Cubic` and `Quartic`, higher degrees with the Jenkins-Traub method
+   * using a workspace for each thread.
+   *
+   * The coefficients of the i-th polynomial (leading first) are
+   * `coeffs[offset[i]]`, ..., `coeffs[offset[i]+degree[i]]` where
+   * `offset[0] = 0` and `offset[i+1] = offset[i]+degree[i]+1`. Its roots
+   * are stored in `zeror[offset[i]-i]`, ..., `zeror[offset[i]-i+degree[i]-1]`
+   * (and `zeroi`), so the output arrays have `offset[n]-n` elements and each
+   * thread writes only its own entries.
+   *
+   * \param[in]  n         number of polynomials
+   * \param[in]  degree    degree of the polynomials
+   * \param[in]  offset    offset of the coefficients of the polynomials (size n+1)
+   * \param[in]  coeffs    packed coefficients
+   * \param[out] zeror     real part of the roots
+   * \param[out] zeroi     imaginary part of the roots
+   * \param[out] info      0 if the polynomial is solved, < 0 as returned by `roots`
+   * \param[in]  nthreads  number of threads, if 0 use the number of cores
+   * \param[out] stats     if not NULL, timing of each thread (one entry for each thread used)
+   * \return the number of threads used
+   */
+  template <typename Real>
+  indexType
+  solveBatchParallel(
+    indexType          n,
+    indexType const    degree[],
+    indexType const    offset[],
+    Real const         coeffs[],
+    Real               zeror[],
+    Real               zeroi[],
+    indexType          info[],
+    indexType          nthreads = 0,
+    ParallelBatchStats stats[] = NULL
+  );
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |    ____           _
+   |   / ___|__ _  ___| |__   ___
+   |  | |   / _` |/ __| '_ \ / _ \
+   |  | |__| (_| | (__| | | |  __/
+   |   \____\__,_|\___|_| |_|\___|
+  \*/
+
+  //! counters of a `RootsCacheT`
+  struct RootsCacheStats {
+    unsigned long long hits;      //!< roots found in the cache
+    unsigned long long misses;    //!< roots computed and stored
+    unsigned long long evictions; //!< entries replaced when the cache is full
+    unsigned long long bypassed;  //!< polynomials not normalized (zero leading coefficient, \f$ x^n \f$)
+    indexType          size;      //!< number of entries stored
+  };
+
+  //! bounded cache of roots keyed on the normalized coefficients
+  /*!
+   * A polynomial is normalized by dividing by the leading coefficient and
+   * scaling the variable so that the largest of
+   * \f$ |a_i/a_0|^{1/i} \f$ is 1, as `Cubic` and `Quartic` do before the
+   * Newton iterations (the generic polynomials are scaled by a power of two).
+   * Polynomials differing by a common factor or by a scale of the roots
+   * share an entry when the normalized coefficients round to the same
+   * values, always for powers of two: the roots of the normalized
+   * polynomial are stored and scaled back on each hit.
+   *
+   * At most `capacity` entries are stored, when the cache is full an
+   * entry is replaced with the CLOCK policy (an approximation of least
+   * recently used). The cache can be shared between threads: a lookup
+   * locks a mutex, the roots of a miss are computed without the lock.
+   *
+   * The roots are in the order of `getRoot0`, `getRoot1`, ... of
+   * `Cubic` and `Quartic` and of `roots` respectively and agree with them
+   * to the rounding of the normalization.
+   */
+  template <typename Real>
+  class RootsCacheT {
+    class Impl;
+    Impl * impl;
+
+    RootsCacheT( RootsCacheT const & );
+    RootsCacheT const & operator = ( RootsCacheT const & );
+
+  public:
+
+    explicit
+    RootsCacheT( indexType capacity = 4096 );
+
+    ~RootsCacheT();
+
+    //! maximum number of entries
+    indexType getCapacity() const;
+
+    //! roots of `a*x^3 + b*x^2 + c*x + d` as computed by `Cubic`, return the number of roots
+    indexType
+    cubic(
+      Real a,
+      Real b,
+      Real c,
+      Real d,
+      Real zeror[],
+      Real zeroi[]
+    );
+
+    //! roots of `a*x^4 + b*x^3 + c*x^2 + d*x + e` as computed by `Quartic`, return the number of roots
+    indexType
+    quartic(
+      Real a,
+      Real b,
+      Real c,
+      Real d,
+      Real e,
+      Real zeror[],
+      Real zeroi[]
+    );
+
+    //! roots of a generic polynomial as computed by `roots`, with the same return value
+    int
+    roots(
+      Real const op[],
+      indexType  Degree,
+      Real       zeror[],
+      Real       zeroi[]
+    );
+
+    //! counters of the cache
+    RootsCacheStats getStats() const;
+
+    //! remove all the entries and reset the counters
+    void clear();
+  };
+
+  typedef RootsCacheT<valueType> RootsCache; //!< cache in double precision
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |   ____  _        _
+   |  / ___|| |_ __ _| |_ ___
+   |  \___ \| __/ _` | __/ __|
+   |   ___) | || (_| | |_\__ \
+   |  |____/ \__\__,_|\__|___/
+  \*/
+
+  //! counters of the paths taken and of the iterations done by the solvers
+  /*!
+   * The counters are updated only when the library is compiled with
+   * `POLYNOMIAL_ROOTS_STATS` defined (CMake option `BUILD_STATS`, or
+   * `make STATS=1`), otherwise the instrumentation is not compiled at all
+   * and all the counters stay zero. Each thread updates its own counters,
+   * `getGlobalStats` sums the counters of all the threads.
+   *
+   * The quartic solver uses the cubic solver internally, so the cubic
+   * counters include the cubics solved on behalf of `Quartic`.
+   */
+  struct SolverStats {
+    enum Counter {
+      CUBIC_SOLVES = 0,         //!< cubics solved
+      CUBIC_SPECIAL,            //!< cubics with a = 0 or d = 0 (solved as quadratic)
+      CUBIC_TRIPLE,             //!< triple roots detected before iterating
+      CUBIC_SHIFTED,            //!< Newton done on the shifted cubic (near triple root)
+      CUBIC_NEWTON_ITER,        //!< Newton iterations
+      CUBIC_BISECTION,          //!< fallbacks to bisection
+      CUBIC_BISECTION_ITER,     //!< bisection iterations
+      CUBIC_WARM,               //!< `update` solved from the previous root
+      CUBIC_WARM_FALLBACK,      //!< `update` solved as `setup`
+      CUBIC_TABLE,              //!< Newton started from the table of `POLYNOMIAL_ROOTS_CUBIC_TABLE`
+      CUBIC_TABLE_FALLBACK,     //!< Halley from the table not converged, Newton-bisection
+      CUBIC_CLOSED_FORM,        //!< `setupClosedForm` solved by the closed form
+      CUBIC_CLOSED_FORM_FALLBACK, //!< `setupClosedForm` solved as `setup` (error estimate too large)
+      QUARTIC_SOLVES,           //!< quartics solved
+      QUARTIC_CUBIC,            //!< quartics with a = 0 or e = 0 (solved as cubic)
+      QUARTIC_BIQUADRATIC,      //!< quartics with b = d = 0 (solved as quadratic)
+      QUARTIC_REAL_ROOT,        //!< Newton on a real root followed by deflation
+      QUARTIC_HEXIC,            //!< only complex roots, Newton on the hexic
+      QUARTIC_EQUAL_REAL_PARTS, //!< only complex roots with equal real parts
+      QUARTIC_REAL_ONLY_EXIT,   //!< `solveQuarticReal` stopped, no real roots
+      QUARTIC_NEWTON_ITER,      //!< Newton (Halley) iterations, quartic and hexic
+      QUARTIC_BISECTION,        //!< fallbacks to bisection, quartic and hexic
+      QUARTIC_BISECTION_ITER,   //!< bisection iterations, quartic and hexic
+      QUARTIC_WARM,             //!< `update` solved from the previous roots
+      QUARTIC_WARM_FALLBACK,    //!< `update` solved as `setup`
+      QUARTIC_CLOSED_FORM,      //!< `setupClosedForm` solved by the resolvent cubic
+      QUARTIC_CLOSED_FORM_FALLBACK, //!< `setupClosedForm` solved as `setup` (residual too large)
+      JT_SOLVES,                //!< polynomials solved by Jenkins-Traub
+      JT_SHIFTS,                //!< fixed shift stages (calls of FixedShift)
+      JT_SHIFT_RETRIES,         //!< fixed shift stages failed and restarted with a new shift
+      JT_QUADIT,                //!< quadratic (variable shift) iterations attempted
+      JT_REALIT,                //!< real (variable shift) iterations attempted
+      JT_FAILURES,              //!< Jenkins-Traub failures (no convergence with 20 shifts)
+      LOCUS_STEPS,              //!< `rootLocus` predictor-corrector steps accepted
+      LOCUS_REJECTED,           //!< `rootLocus` steps rejected (step size halved)
+      LOCUS_COLLISIONS,         //!< `rootLocus` collisions of two roots detected
+      LOCUS_FULL_SOLVES,        //!< `rootLocus` roots computed from scratch
+      STURM_COUNTS,             //!< intervals checked by the Sturm counting functions
+      STURM_REJECTED,           //!< intervals without roots by the bound of |p'|, no sequence evaluated
+      numCounters
+    };
+
+    unsigned long long count[numCounters];
+
+    SolverStats() { reset(); }
+
+    void reset() { for ( int i = 0; i < numCounters; ++i ) count[i] = 0; }
+
+    unsigned long long operator [] ( Counter i ) const { return count[i]; }
+
+    SolverStats &
+    operator += ( SolverStats const & s ) {
+      for ( int i = 0; i < numCounters; ++i ) count[i] += s.count[i];
+      return *this;
+    }
+
+    //! name of the counter `i`
+    static char const * name( Counter i );
+
+    //! print the nonzero counters
+    void info( std::ostream & s ) const;
+  };
+
+  //! true if the library is compiled with the instrumentation (`POLYNOMIAL_ROOTS_STATS`)
+  bool statsEnabled();
+
+  //! counters of the calling thread
+  SolverStats getThreadStats();
+
+  //! sum of the counters of all the threads, running or terminated
+  SolverStats getGlobalStats();
+
+  //! set to zero the counters of all the threads (call when no solver is running)
+  void resetStats();
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  /*\
+   |   ____  _                 _       _
+   |  |  _ \(_)___ _ __   __ _| |_ ___| |__
+   |  | | | | / __| '_ \ / _` | __/ __| '_ \
+   |  | |_| | \__ \ |_) | (_| | || (__| | | |
+   |  |____/|_|___/ .__/ \__,_|\__\___|_| |_|
+   |              |_|
+  \*/
+
+  //! instruction set used by the batch kernels
+  /*!
+   * The batch solvers (`evalPoly` and `evalPolyC` on arrays of points,
+   * `solveQuadraticBatch`, `solveCubicBatch` and the lockstep iteration of
+   * `solveQuarticBatch`) are compiled for each level and the best level
+   * supported by the CPU is selected when the library is loaded. The
+   * variants use the same operations in the same order (no fused
+   * multiply-add), so the roots do not depend on the level.
+   *
+   * The dispatch is available with GCC and Clang on x86, it is disabled
+   * defining `POLYNOMIAL_ROOTS_NO_DISPATCH` (CMake option
+   * `BUILD_NO_DISPATCH`, or `make NODISPATCH=1`), in that case only
+   * `SIMD_GENERIC` (the flags used to compile the library) is available.
+   */
+  enum SimdLevel {
+    SIMD_GENERIC = 0, //!< compiled with the flags of the library
+    SIMD_SSE42,       //!< SSE4.2
+    SIMD_AVX2,        //!< AVX2, 256 bit vectors
+    SIMD_AVX512       //!< AVX-512 (F, VL, DQ), 512 bit vectors
+  };
+
+  //! level used by the batch kernels
+  SimdLevel simdLevel();
+
+  //! best level supported by the CPU and by the build
+  SimdLevel simdLevelMax();
+
+  //! name of the level `l`
+  char const * simdLevelName( SimdLevel l );
+
+  //! select the level of the batch kernels, clamped to `simdLevelMax()`,
+  //! return the level selected (solvers running in other threads use the
+  //! new level from their next batch kernel)
+  SimdLevel setSimdLevel( SimdLevel l );
+
   /*\
    |   _   _ _   _ _
    |  | | | | |_(_) |___
@@ -666,32 +1698,28 @@ namespace PolynomialRoots {
   \*/
 
   // x^3 + a*x^2 + b*x + c
-  static
-  inline
-  valueType
+  template <typename Real>
+  constexpr
+  Real
   evalMonicCubic(
-    valueType x,
-    valueType a,
-    valueType b,
-    valueType c
+    Real x,
+    Real a,
+    Real b,
+    Real c
   ) {
-    valueType p;
-    p = x + a;
-    p = p * x + b;
-    p = p * x + c;
-    return p;
+    return ((x + a) * x + b) * x + c;
   }
 
-  static
+  template <typename Real>
   inline
   void
   evalMonicCubic(
-    valueType   x,
-    valueType   a,
-    valueType   b,
-    valueType   c,
-    valueType & p,
-    valueType & dp
+    Real   x,
+    Real   a,
+    Real   b,
+    Real   c,
+    Real & p,
+    Real & dp
   ) {
     p  = x + a;
     dp = x + p;
@@ -702,17 +1730,17 @@ namespace PolynomialRoots {
 
   // 3*x^2 + 2*a*x + b
   // 6*x + 2*a
-  static
+  template <typename Real>
   inline
   void
   evalMonicCubic(
-    valueType   x,
-    valueType   a,
-    valueType   b,
-    valueType   c,
-    valueType & p,
-    valueType & dp,
-    valueType & ddp
+    Real   x,
+    Real   a,
+    Real   b,
+    Real   c,
+    Real & p,
+    Real & dp,
+    Real & ddp
   ) {
     p   = x + a;
     dp  = x + p;      // 2*x + a
@@ -723,35 +1751,30 @@ namespace PolynomialRoots {
   }
 
   // x^4 + a*x^3 + b*x^2 + c*x + d
-  static
-  inline
-  valueType
+  template <typename Real>
+  constexpr
+  Real
   evalMonicQuartic(
-    valueType x,
-    valueType a,
-    valueType b,
-    valueType c,
-    valueType d
+    Real x,
+    Real a,
+    Real b,
+    Real c,
+    Real d
   ) {
-    valueType p;
-    p = x + a;     // x + a
-    p = p * x + b; // x^2+ a*x + b
-    p = p * x + c; // x^3+ a*x^2 + b*x + c
-    p = p * x + d; // x^4+ a*x^3 + b*x^2 + c*x + d
-    return p;
+    return (((x + a) * x + b) * x + c) * x + d; // x^4+ a*x^3 + b*x^2 + c*x + d
   }
 
-  static
+  template <typename Real>
   inline
   void
   evalMonicQuartic(
-    valueType   x,
-    valueType   a,
-    valueType   b,
-    valueType   c,
-    valueType   d,
-    valueType & p,
-    valueType & dp
+    Real   x,
+    Real   a,
+    Real   b,
+    Real   c,
+    Real   d,
+    Real & p,
+    Real & dp
   ) {
     p  = x + a;      // x + a
     dp = x + p;      // 2*x + a
@@ -762,18 +1785,18 @@ namespace PolynomialRoots {
     p  = p  * x + d; // x^4+ a*x^3 + b*x^2 + c*x + d
   }
 
-  static
+  template <typename Real>
   inline
   void
   evalMonicQuartic(
-    valueType   x,
-    valueType   a,
-    valueType   b,
-    valueType   c,
-    valueType   d,
-    valueType & p,
-    valueType & dp,
-    valueType & ddp
+    Real   x,
+    Real   a,
+    Real   b,
+    Real   c,
+    Real   d,
+    Real & p,
+    Real & dp,
+    Real & ddp
   ) {
     // p_{n+1}(x)   = x * p_{n}(x) + b_{n}
     // p'_{n+1}(x)  = x * p'_{n}(x) + p_{n}(x)
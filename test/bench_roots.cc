@@ -0,0 +1,663 @@
+/*
+.. This program measures the speed of the solvers (ns per solve and solves
+.. per second) on sets of polynomials with random coefficients, clustered
+.. roots, wide dynamic range of the roots and on the ill-conditioned quartics
+.. of check_3_quartic.
+..
+.. Usage: bench_roots [seconds]
+..   seconds minimum time spent for each measure (default 0.2)
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+typedef vector<valueType> Poly;
+
+// sum of the computed roots, printed at the end so that the solves are not optimized out
+static valueType checksum = 0;
+
+static double minSeconds = 0.2;
+
+static double const sqrt2 = sqrt(2.0);
+
+// ill-conditioned quartics, the same of check_3_quartic
+static double const quartics[][5] = {
+  { -5.898376305898030e-09, -6.000000000001007e+06, 3.664603343001005e-27, 0, 9.000000000003021e+02 },
+  { 1, -1001001001.0, 1001002001001000.0, -1001001001000000000.0, 1000000000000000000.0 },
+  { 1, -4.006, +6.018011, -4.018022006, +1.006011006 },
+  { 1, -9.988990e79, -1.100898900e157, -1.010999e233, -1e307 },
+  { 1, -1.00000000000002e+14, +1.99999999999999e+14, +1.00000000000002e+14, -2.e+14 },
+  { 1, +1.e+7, -2.00000000000001e+14, -1.e+7, +2.e+14 },
+  { 1, -9.000002e+6, -0.9999981999998e+13, +1.9999982e+13, -2.e+13 },
+  { 1, +2.000011e+6, +1.010022000028e+12, +1.1110056e+13, +2.828e+13 },
+  { 1, -1.00002011e8, +2.01101022001e11, -1.02200111000011e14, 1.1000011e15 },
+  { 1, -2.0000002e+7, +1.01000040000005e+14, -2.020001e+14, +5.05e+14 },
+  { 1, -1.9986e+4, +1.00720058e+8, -1.8600979874e+10, +1.00004909000441e+14 },
+  { 1, -4.006, +5.6008018e+1, -1.04148036024e+2, +6.75896068064016e+2 },
+  { 1, -4.0e+3, +6.00001e+6, -4.00002e+9, +1.000010000009e+12 },
+  { 1, -6.0, +1.01000013e+8, -2.04000012e+8, +1.00000104000004e+14 },
+  { 714285.71428571432, -100000, 13479.924671428573, -2.2737367544323206e-13, -22.526485131747265 },
+  { 1, -3*sqrt2, 6, -2*sqrt2, 0 },
+  { 1, 3*sqrt2, 6, 2*sqrt2, 0 },
+  { 0.000158925, -0.00657522, 0.0801029, -0.2, 0.01 },
+  { 2.25, 36, 113.698199211166496525038382969796657562255859375,
+    -242.41440631066808464311179704964160919189453125,
+    102.0221256717945692571447580121457576751708984375 }
+};
+
+/*
+.. Generators of the test polynomials
+*/
+
+static
+valueType
+uniform( valueType a, valueType b ) {
+  return a + (b-a)*valueType(rand())/RAND_MAX;
+}
+
+// coefficients (leading first) of the monic polynomial with roots r[]
+static
+Poly
+fromRoots( vector<valueType> const & r ) {
+  Poly p( r.size()+1, 0 );
+  p[0] = 1;
+  for ( size_t k = 0; k < r.size(); ++k )
+    for ( size_t i = k+1; i > 0; --i )
+      p[i] -= r[k]*p[i-1];
+  return p;
+}
+
+static
+vector<Poly>
+randomCoeffs( indexType degree, indexType n ) {
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    ps[k].resize(degree+1);
+    for ( indexType i = 0; i <= degree; ++i ) ps[k][i] = uniform(-1,1);
+  }
+  return ps;
+}
+
+// roots in a cluster of width 1e-3 around a random center
+static
+vector<Poly>
+clusteredRoots( indexType degree, indexType n ) {
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    valueType c = uniform(-10,10);
+    vector<valueType> r(degree);
+    for ( indexType i = 0; i < degree; ++i ) r[i] = c + uniform(0,1e-3);
+    ps[k] = fromRoots(r);
+  }
+  return ps;
+}
+
+// roots of random sign with magnitude from 1e-8 to 1e8
+static
+vector<Poly>
+wideRangeRoots( indexType degree, indexType n ) {
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    vector<valueType> r(degree);
+    for ( indexType i = 0; i < degree; ++i )
+      r[i] = (rand()%2 ? 1 : -1) * pow( 10.0, uniform(-8,8) );
+    ps[k] = fromRoots(r);
+  }
+  return ps;
+}
+
+// a stream of polynomials with slowly moving roots, as in a simulation
+static
+vector<Poly>
+coherentRoots( indexType degree, indexType n ) {
+  vector<valueType> r0(degree), w(degree), r(degree);
+  for ( indexType i = 0; i < degree; ++i ) {
+    r0[i] = uniform(-10,10);
+    w[i]  = uniform(0.5,2);
+  }
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    for ( indexType i = 0; i < degree; ++i ) r[i] = r0[i] + sin( w[i]*k*1e-3 );
+    ps[k] = fromRoots(r);
+  }
+  return ps;
+}
+
+// 16 random quartics repeated with the roots scaled by a power of two
+static
+vector<Poly>
+repeatedQuartics( indexType n ) {
+  vector<Poly> base = randomCoeffs(4,16);
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    Poly const & b = base[size_t(rand()%16)];
+    valueType    s = ldexp( 1.0, rand()%9-4 ), sk = 1;
+    ps[k].resize(5);
+    for ( indexType i = 0; i <= 4; ++i ) { ps[k][i] = b[i]*sk; sk *= s; }
+  }
+  return ps;
+}
+
+// p + k*q for n gains k = 0, 0.01, ..., p and q random, saved for solveLocus
+static vector<valueType> locusP, locusQ, locusK;
+
+static
+vector<Poly>
+locusPolys( indexType degree, indexType n ) {
+  locusP.resize(degree+1);
+  locusQ.resize(degree+1);
+  locusK.resize(n);
+  for ( indexType i = 0; i <= degree; ++i ) {
+    locusP[i] = uniform(-1,1);
+    locusQ[i] = i == 0 ? 0 : uniform(-1,1); // constant degree
+  }
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    locusK[k] = k*valueType(0.01);
+    ps[k].resize(degree+1);
+    for ( indexType i = 0; i <= degree; ++i ) ps[k][i] = locusP[i] + locusK[k]*locusQ[i];
+  }
+  return ps;
+}
+
+// products of two quadratics with complex roots, quartics with no real roots
+static
+vector<Poly>
+complexQuartics( indexType n ) {
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    valueType p1 = uniform(-2,2), q1 = p1*p1/4 + uniform(0.01,1);
+    valueType p2 = uniform(-2,2), q2 = p2*p2/4 + uniform(0.01,1);
+    Poly p(5);
+    p[0] = 1;
+    p[1] = p1+p2;
+    p[2] = q1+q2+p1*p2;
+    p[3] = p1*q2+p2*q1;
+    p[4] = q1*q2;
+    ps[k] = p;
+  }
+  return ps;
+}
+
+static
+vector<Poly>
+illConditionedQuartics() {
+  indexType n = indexType(sizeof(quartics)/sizeof(quartics[0]));
+  vector<Poly> ps(n);
+  for ( indexType k = 0; k < n; ++k ) ps[k].assign( quartics[k], quartics[k]+5 );
+  return ps;
+}
+
+/*
+.. Solvers, each call solves all the polynomials of the set once
+*/
+
+static
+void
+solveQuadratic( vector<Poly> const & ps ) {
+  Quadratic q;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    q.setup( ps[k][0], ps[k][1], ps[k][2] );
+    checksum += q.real_root0();
+  }
+}
+
+// the conversion to structure of arrays is included in the time
+static
+void
+solveQuadraticSoA( vector<Poly> const & ps ) {
+  static vector<valueType> A, B, C, r0, r1;
+  static vector<indexType> nrts;
+  static vector<char>      flags; // vector<bool> is not an array of bool
+  indexType n = indexType(ps.size());
+  A.resize(n); B.resize(n); C.resize(n); r0.resize(n); r1.resize(n);
+  nrts.resize(n); flags.resize(2*n);
+  for ( indexType k = 0; k < n; ++k ) {
+    A[k] = ps[k][0];
+    B[k] = ps[k][1];
+    C[k] = ps[k][2];
+  }
+  solveQuadraticBatch( n, &A.front(), &B.front(), &C.front(),
+                       &r0.front(), &r1.front(), &nrts.front(),
+                       reinterpret_cast<bool*>(&flags.front()),
+                       reinterpret_cast<bool*>(&flags.front())+n );
+  for ( indexType k = 0; k < n; ++k ) checksum += r0[k];
+}
+
+static
+void
+solveCubic( vector<Poly> const & ps ) {
+  Cubic c;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    c.setup( ps[k][0], ps[k][1], ps[k][2], ps[k][3] );
+    checksum += c.real_root0();
+  }
+}
+
+// closed form root, setup where the error estimate is too large
+static
+void
+solveCubicClosedForm( vector<Poly> const & ps ) {
+  Cubic c;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    c.setupClosedForm( ps[k][0], ps[k][1], ps[k][2], ps[k][3] );
+    checksum += c.real_root0();
+  }
+}
+
+// each cubic starts from the roots of the previous one
+static
+void
+solveCubicWarm( vector<Poly> const & ps ) {
+  Cubic c;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    c.update( ps[k][0], ps[k][1], ps[k][2], ps[k][3] );
+    checksum += c.real_root0();
+  }
+}
+
+// the conversion to structure of arrays is included in the time
+static
+void
+solveCubicSoA( vector<Poly> const & ps ) {
+  static vector<valueType> A, B, C, D, r0, r1, r2;
+  static vector<indexType> nrts;
+  static vector<char>      flags; // vector<bool> is not an array of bool
+  indexType n = indexType(ps.size());
+  A.resize(n); B.resize(n); C.resize(n); D.resize(n);
+  r0.resize(n); r1.resize(n); r2.resize(n); nrts.resize(n); flags.resize(3*n);
+  for ( indexType k = 0; k < n; ++k ) {
+    A[k] = ps[k][0];
+    B[k] = ps[k][1];
+    C[k] = ps[k][2];
+    D[k] = ps[k][3];
+  }
+  bool * f = reinterpret_cast<bool*>(&flags.front());
+  solveCubicBatch( n, &A.front(), &B.front(), &C.front(), &D.front(),
+                   &r0.front(), &r1.front(), &r2.front(), &nrts.front(),
+                   f, f+n, f+2*n );
+  for ( indexType k = 0; k < n; ++k ) checksum += r0[k];
+}
+
+static
+void
+solveQuartic( vector<Poly> const & ps ) {
+  Quartic q;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    q.setup( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4] );
+    checksum += q.real_root0();
+  }
+}
+
+// each quartic starts from the roots of the previous one
+static
+void
+solveQuarticWarm( vector<Poly> const & ps ) {
+  Quartic q;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    q.update( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4] );
+    checksum += q.real_root0();
+  }
+}
+
+// factorization by the resolvent cubic, setup where a residual is too large
+static
+void
+solveQuarticClosedForm( vector<Poly> const & ps ) {
+  Quartic q;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    q.setupClosedForm( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4] );
+    checksum += q.real_root0();
+  }
+}
+
+// the cache is shared by the repetitions, after the warm up all are hits
+static
+void
+solveQuarticCached( vector<Poly> const & ps ) {
+  static RootsCache cache( 64 );
+  valueType zr[4], zi[4];
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    cache.quartic( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4], zr, zi );
+    checksum += zr[0];
+  }
+}
+
+// the conversion to structure of arrays is included in the time
+static
+void
+solveQuarticSoA( vector<Poly> const & ps ) {
+  static vector<valueType> A, B, C, D, E, r0, r1, r2, r3;
+  static vector<indexType> nreal, ncplx;
+  indexType n = indexType(ps.size());
+  A.resize(n); B.resize(n); C.resize(n); D.resize(n); E.resize(n);
+  r0.resize(n); r1.resize(n); r2.resize(n); r3.resize(n);
+  nreal.resize(n); ncplx.resize(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    A[k] = ps[k][0];
+    B[k] = ps[k][1];
+    C[k] = ps[k][2];
+    D[k] = ps[k][3];
+    E[k] = ps[k][4];
+  }
+  solveQuarticBatch( n, &A.front(), &B.front(), &C.front(), &D.front(), &E.front(),
+                     &r0.front(), &r1.front(), &r2.front(), &r3.front(),
+                     &nreal.front(), &ncplx.front() );
+  for ( indexType k = 0; k < n; ++k ) checksum += r0[k];
+}
+
+static
+void
+solveQuarticRealRoots( vector<Poly> const & ps ) {
+  valueType r[4];
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    if ( solveQuarticReal( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4], r ) > 0 )
+      checksum += r[0];
+  }
+}
+
+// smallest root in [0,5], as for the intersection of rays with quartic surfaces
+static
+void
+solveQuarticFirstRoot( vector<Poly> const & ps ) {
+  valueType x;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    if ( solveQuarticInterval( ps[k][0], ps[k][1], ps[k][2], ps[k][3], ps[k][4],
+                               valueType(0), valueType(5), x ) )
+      checksum += x;
+  }
+}
+
+// number of roots in [0.5,0.55], most of the intervals have no roots
+static valueType const countLo = 0.5;
+static valueType const countHi = 0.55;
+
+static
+void
+countRootsSturm( vector<Poly> const & ps ) {
+  for ( size_t k = 0; k < ps.size(); ++k )
+    checksum += countRealRoots( &ps[k].front(), indexType(ps[k].size()-1), countLo, countHi );
+}
+
+// the conversion to structure of arrays is included in the time
+static
+void
+countQuarticRootsSoA( vector<Poly> const & ps ) {
+  static vector<valueType> A, B, C, D, E, lo, hi;
+  static vector<indexType> count;
+  indexType n = indexType(ps.size());
+  A.resize(n); B.resize(n); C.resize(n); D.resize(n); E.resize(n);
+  lo.assign( n, countLo ); hi.assign( n, countHi ); count.resize(n);
+  for ( indexType k = 0; k < n; ++k ) {
+    A[k] = ps[k][0];
+    B[k] = ps[k][1];
+    C[k] = ps[k][2];
+    D[k] = ps[k][3];
+    E[k] = ps[k][4];
+  }
+  checksum += countQuarticRootsBatch( n, &A.front(), &B.front(), &C.front(), &D.front(),
+                                      &E.front(), &lo.front(), &hi.front(), &count.front() );
+}
+
+static
+void
+solveJenkinsTraub( vector<Poly> const & ps ) {
+  valueType zr[64], zi[64];
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    roots( &ps[k].front(), indexType(ps[k].size()-1), zr, zi );
+    checksum += zr[0];
+  }
+}
+
+// the polynomials of locusPolys by rootLocus, tracking the roots along k
+static
+void
+solveLocus( vector<Poly> const & ps ) {
+  static vector<valueType> zr, zi;
+  static vector<indexType> info;
+  indexType degree = indexType(locusP.size()-1);
+  indexType n      = indexType(ps.size());
+  zr.resize(n*degree); zi.resize(n*degree); info.resize(n);
+  rootLocus( &locusP.front(), degree, &locusQ.front(), degree,
+             &locusK.front(), n, &zr.front(), &zi.front(), &info.front() );
+  checksum += zr[0];
+}
+
+// the same followed by the polishing on the undeflated polynomial
+static
+void
+solveJenkinsTraubPolish( vector<Poly> const & ps ) {
+  valueType zr[64], zi[64];
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    indexType degree = indexType(ps[k].size()-1);
+    roots( &ps[k].front(), degree, zr, zi );
+    polishRoots( &ps[k].front(), degree, zr, zi );
+    checksum += zr[0];
+  }
+}
+
+// evaluation of the polynomials at the points evalPoints, one at a time or in a batch
+static vector<valueType> evalPoints, evalValues;
+
+static
+void
+evalScalar( vector<Poly> const & ps ) {
+  indexType n = indexType(evalPoints.size());
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    indexType degree = indexType(ps[k].size()-1);
+    for ( indexType i = 0; i < n; ++i )
+      evalValues[i] = evalPoly( &ps[k].front(), degree, evalPoints[i] );
+    checksum += evalValues[n-1];
+  }
+}
+
+static
+void
+evalBatch( vector<Poly> const & ps ) {
+  indexType n = indexType(evalPoints.size());
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    evalPoly( &ps[k].front(), indexType(ps[k].size()-1),
+              &evalPoints.front(), n, &evalValues.front() );
+    checksum += evalValues[n-1];
+  }
+}
+
+// residuals at the complex points evalPoints + I*evalImag
+static vector<valueType> evalImag, evalValuesI;
+
+static
+void
+evalScalarC( vector<Poly> const & ps ) {
+  indexType n = indexType(evalPoints.size());
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    indexType degree = indexType(ps[k].size()-1);
+    for ( indexType i = 0; i < n; ++i ) {
+      complexType p = evalPolyC( &ps[k].front(), degree, complexType(evalPoints[i],evalImag[i]) );
+      evalValues[i]  = p.real();
+      evalValuesI[i] = p.imag();
+    }
+    checksum += evalValues[n-1];
+  }
+}
+
+static
+void
+evalBatchC( vector<Poly> const & ps ) {
+  indexType n = indexType(evalPoints.size());
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    evalPolyC( &ps[k].front(), indexType(ps[k].size()-1),
+               &evalPoints.front(), &evalImag.front(), n,
+               &evalValues.front(), &evalValuesI.front() );
+    checksum += evalValues[n-1];
+  }
+}
+
+// average number of iterations of Cubic, compare the builds with and
+// without the table of starting points (BUILD_CUBIC_TABLE)
+static
+void
+cubicIterations( char const * distribution, vector<Poly> const & ps ) {
+  Cubic  c;
+  double iter = 0;
+  for ( size_t k = 0; k < ps.size(); ++k ) {
+    c.setup( ps[k][0], ps[k][1], ps[k][2], ps[k][3] );
+    iter += c.numIter();
+  }
+  cout << setw(16) << left  << "Cubic"
+       << setw(20) << left  << distribution
+       << setw(12) << right << fixed << setprecision(2) << iter/double(ps.size())
+       << '\n';
+}
+
+// repeat the solves until at least minSeconds are spent and print the timing
+static
+void
+bench(
+  char const *         solver,
+  char const *         distribution,
+  void (*solve)( vector<Poly> const & ),
+  vector<Poly> const & ps
+) {
+  typedef chrono::steady_clock clock;
+  solve( ps ); // warm up
+  indexType nrep    = 0;
+  double    seconds = 0;
+  clock::time_point start = clock::now();
+  while ( seconds < minSeconds ) {
+    solve( ps );
+    ++nrep;
+    seconds = chrono::duration<double>( clock::now() - start ).count();
+  }
+  double nsolve = double(nrep)*double(ps.size());
+  cout << setw(16) << left  << solver
+       << setw(20) << left  << distribution
+       << setw(12) << right << fixed << setprecision(1) << 1e9*seconds/nsolve
+       << setw(16) << right << fixed << setprecision(0) << nsolve/seconds
+       << '\n';
+}
+
+int
+main( int argc, char const * argv[] ) {
+  if ( argc > 1 ) minSeconds = atof( argv[1] );
+  srand(1234);
+
+  indexType const N = 1000;
+
+  cout << "batch kernels: " << simdLevelName( simdLevel() ) << '\n';
+  #ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+  cout << "cubic starting points: table\n\n";
+  #else
+  cout << "cubic starting points: fits\n\n";
+  #endif
+  cout << setw(16) << left  << "solver"
+       << setw(20) << left  << "distribution"
+       << setw(12) << right << "ns/solve"
+       << setw(16) << right << "solves/sec"
+       << '\n';
+
+  bench( "Quadratic", "random", solveQuadratic, randomCoeffs(2,N) );
+  bench( "Quadratic", "clustered", solveQuadratic, clusteredRoots(2,N) );
+  bench( "Quadratic", "wide range", solveQuadratic, wideRangeRoots(2,N) );
+  bench( "Quadratic x[]", "random", solveQuadraticSoA, randomCoeffs(2,N) );
+  bench( "Quadratic x[]", "clustered", solveQuadraticSoA, clusteredRoots(2,N) );
+  bench( "Quadratic x[]", "wide range", solveQuadraticSoA, wideRangeRoots(2,N) );
+
+  bench( "Cubic", "random", solveCubic, randomCoeffs(3,N) );
+  bench( "Cubic", "clustered", solveCubic, clusteredRoots(3,N) );
+  bench( "Cubic", "wide range", solveCubic, wideRangeRoots(3,N) );
+  bench( "Cubic", "coherent", solveCubic, coherentRoots(3,N) );
+  bench( "Cubic warm", "coherent", solveCubicWarm, coherentRoots(3,N) );
+  bench( "Cubic closed", "random", solveCubicClosedForm, randomCoeffs(3,N) );
+  bench( "Cubic closed", "clustered", solveCubicClosedForm, clusteredRoots(3,N) );
+  bench( "Cubic closed", "wide range", solveCubicClosedForm, wideRangeRoots(3,N) );
+  bench( "Cubic x[]", "random", solveCubicSoA, randomCoeffs(3,N) );
+  bench( "Cubic x[]", "clustered", solveCubicSoA, clusteredRoots(3,N) );
+  bench( "Cubic x[]", "wide range", solveCubicSoA, wideRangeRoots(3,N) );
+
+  bench( "Quartic", "random", solveQuartic, randomCoeffs(4,N) );
+  bench( "Quartic", "clustered", solveQuartic, clusteredRoots(4,N) );
+  bench( "Quartic", "wide range", solveQuartic, wideRangeRoots(4,N) );
+  bench( "Quartic", "quartic0..18", solveQuartic, illConditionedQuartics() );
+  bench( "Quartic", "no real roots", solveQuartic, complexQuartics(N) );
+  bench( "Quartic", "coherent", solveQuartic, coherentRoots(4,N) );
+  bench( "Quartic warm", "coherent", solveQuarticWarm, coherentRoots(4,N) );
+  bench( "Quartic closed", "random", solveQuarticClosedForm, randomCoeffs(4,N) );
+  bench( "Quartic closed", "clustered", solveQuarticClosedForm, clusteredRoots(4,N) );
+  bench( "Quartic closed", "wide range", solveQuarticClosedForm, wideRangeRoots(4,N) );
+  bench( "Quartic closed", "no real roots", solveQuarticClosedForm, complexQuartics(N) );
+  bench( "Quartic", "16 repeated", solveQuartic, repeatedQuartics(N) );
+  bench( "Quartic cache", "16 repeated", solveQuarticCached, repeatedQuartics(N) );
+  bench( "Quartic x[]", "random", solveQuarticSoA, randomCoeffs(4,N) );
+  bench( "Quartic x[]", "wide range", solveQuarticSoA, wideRangeRoots(4,N) );
+  bench( "Quartic x[]", "no real roots", solveQuarticSoA, complexQuartics(N) );
+  bench( "Quartic real", "random", solveQuarticRealRoots, randomCoeffs(4,N) );
+  bench( "Quartic real", "wide range", solveQuarticRealRoots, wideRangeRoots(4,N) );
+  bench( "Quartic real", "quartic0..18", solveQuarticRealRoots, illConditionedQuartics() );
+  bench( "Quartic [0,5]", "random", solveQuarticFirstRoot, randomCoeffs(4,N) );
+  bench( "Quartic [0,5]", "clustered", solveQuarticFirstRoot, clusteredRoots(4,N) );
+  bench( "Sturm", "random deg 4", countRootsSturm, randomCoeffs(4,N) );
+  bench( "Sturm", "clustered deg 4", countRootsSturm, clusteredRoots(4,N) );
+  bench( "Sturm", "random deg 10", countRootsSturm, randomCoeffs(10,N) );
+  bench( "Sturm x[]", "random deg 4", countQuarticRootsSoA, randomCoeffs(4,N) );
+
+  bench( "roots", "quartic0..18", solveJenkinsTraub, illConditionedQuartics() );
+  bench( "roots", "random deg 5", solveJenkinsTraub, randomCoeffs(5,N) );
+  bench( "roots", "random deg 10", solveJenkinsTraub, randomCoeffs(10,N) );
+  bench( "roots", "random deg 20", solveJenkinsTraub, randomCoeffs(20,N) );
+  bench( "roots+polish", "random deg 20", solveJenkinsTraubPolish, randomCoeffs(20,N) );
+  bench( "roots", "p+k*q deg 10", solveJenkinsTraub, locusPolys(10,N) );
+  bench( "rootLocus", "p+k*q deg 10", solveLocus, locusPolys(10,N) );
+  bench( "roots", "clustered deg 6", solveJenkinsTraub, clusteredRoots(6,N) );
+  bench( "roots", "wide range deg 8", solveJenkinsTraub, wideRangeRoots(8,N) );
+
+  // ns/solve is the time to evaluate one polynomial at all the points
+  evalPoints.resize(1000);
+  evalValues.resize(1000);
+  for ( size_t i = 0; i < evalPoints.size(); ++i ) evalPoints[i] = uniform(-3,3);
+  bench( "evalPoly", "deg 4, 1000 pts", evalScalar, randomCoeffs(4,100) );
+  bench( "evalPoly x[]", "deg 4, 1000 pts", evalBatch, randomCoeffs(4,100) );
+  bench( "evalPoly", "deg 20, 1000 pts", evalScalar, randomCoeffs(20,100) );
+  bench( "evalPoly x[]", "deg 20, 1000 pts", evalBatch, randomCoeffs(20,100) );
+  evalImag.resize(1000);
+  evalValuesI.resize(1000);
+  for ( size_t i = 0; i < evalImag.size(); ++i ) evalImag[i] = uniform(-3,3);
+  bench( "evalPolyC", "deg 4, 1000 pts", evalScalarC, randomCoeffs(4,100) );
+  bench( "evalPolyC z[]", "deg 4, 1000 pts", evalBatchC, randomCoeffs(4,100) );
+  bench( "evalPolyC", "deg 20, 1000 pts", evalScalarC, randomCoeffs(20,100) );
+  bench( "evalPolyC z[]", "deg 20, 1000 pts", evalBatchC, randomCoeffs(20,100) );
+
+  // the batch kernels compiled for each SimdLevel supported by the CPU
+  SimdLevel active = simdLevel();
+  for ( int l = SIMD_GENERIC; l <= simdLevelMax(); ++l ) {
+    string name = simdLevelName( setSimdLevel( SimdLevel(l) ) );
+    cout << '\n' << name << '\n';
+    bench( "Quadratic x[]", "random", solveQuadraticSoA, randomCoeffs(2,N) );
+    bench( "Cubic x[]", "random", solveCubicSoA, randomCoeffs(3,N) );
+    bench( "Quartic x[]", "no real roots", solveQuarticSoA, complexQuartics(N) );
+    bench( "evalPoly x[]", "deg 20, 1000 pts", evalBatch, randomCoeffs(20,100) );
+    bench( "evalPolyC z[]", "deg 20, 1000 pts", evalBatchC, randomCoeffs(20,100) );
+  }
+  setSimdLevel( active );
+
+  cout << '\n'
+       << setw(16) << left  << "solver"
+       << setw(20) << left  << "distribution"
+       << setw(12) << right << "iter/solve"
+       << '\n';
+  cubicIterations( "random", randomCoeffs(3,N) );
+  cubicIterations( "clustered", clusteredRoots(3,N) );
+  cubicIterations( "wide range", wideRangeRoots(3,N) );
+  cubicIterations( "coherent", coherentRoots(3,N) );
+
+  cout << "checksum = " << scientific << checksum << '\n';
+  return 0;
+}
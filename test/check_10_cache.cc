@@ -0,0 +1,139 @@
+/*
+.. This program solves a set of cubic, quartic and higher degree polynomials
+.. through a cache shared by several threads. The polynomials are solved
+.. again multiplied by a constant and with the roots scaled by a power of
+.. two: these must be found in the cache with the roots of the direct solve.
+.. A small cache must evict the entries with the CLOCK policy.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+static indexType const npoly    = 2000;
+static indexType const nthreads = 4;
+
+// polynomial i of the set, coeffs of x^4 ... x^0 or x^7 ... x^0
+struct PolySet {
+  vector<valueType> cubic, quartic, septic;
+  PolySet() : cubic(4*npoly), quartic(5*npoly), septic(8*npoly) {
+    srand(4321);
+    for ( size_t k = 0; k < cubic.size();   ++k ) cubic[k]   = 2*valueType(rand())/RAND_MAX-1;
+    for ( size_t k = 0; k < quartic.size(); ++k ) quartic[k] = 2*valueType(rand())/RAND_MAX-1;
+    for ( size_t k = 0; k < septic.size();  ++k ) septic[k]  = 2*valueType(rand())/RAND_MAX-1;
+  }
+};
+
+// p(x) -> f*p(x/s): the roots are multiplied by s
+static
+void
+rescale( valueType const p[], indexType degree, valueType f, valueType s, valueType q[] ) {
+  valueType sk = 1;
+  for ( indexType k = degree; k >= 0; --k ) { q[k] = f*p[k]*sk; sk /= s; }
+}
+
+static
+bool
+same_roots( valueType const zr[], valueType const zi[],
+            valueType const wr[], valueType const wi[],
+            indexType n, valueType scale ) {
+  for ( indexType i = 0; i < n; ++i ) {
+    valueType err = hypot( zr[i]-wr[i]*scale, zi[i]-wi[i]*scale ) /
+                    (1+hypot( wr[i], wi[i] )*scale);
+    if ( !(err <= 1e-10) ) return false;
+  }
+  return true;
+}
+
+static
+void
+worker( RootsCache & cache, PolySet const & set, indexType t, indexType & nbad ) {
+  valueType q[8], zr[7], zi[7], wr[7], wi[7];
+  nbad = 0;
+  for ( indexType i = t; i < npoly; i += nthreads ) {
+    valueType const * c = &set.cubic[4*i];
+    valueType const * r = &set.quartic[5*i];
+    valueType const * s = &set.septic[8*i];
+
+    // direct solve
+    Cubic cubic( c[0], c[1], c[2], c[3] );
+    cubic.getRoot0( wr[0], wi[0] );
+    cubic.getRoot1( wr[1], wi[1] );
+    cubic.getRoot2( wr[2], wi[2] );
+    indexType nr = cache.cubic( c[0], c[1], c[2], c[3], zr, zi );
+    if ( nr != cubic.numRoots() || !same_roots( zr, zi, wr, wi, nr, 1 ) ) ++nbad;
+
+    // the same cubic scaled must hit the cache
+    rescale( c, 3, -4, 0.25, q );
+    nr = cache.cubic( q[0], q[1], q[2], q[3], zr, zi );
+    if ( nr != cubic.numRoots() || !same_roots( zr, zi, wr, wi, nr, 0.25 ) ) ++nbad;
+
+    Quartic quartic( r[0], r[1], r[2], r[3], r[4] );
+    quartic.getRoot0( wr[0], wi[0] );
+    quartic.getRoot1( wr[1], wi[1] );
+    quartic.getRoot2( wr[2], wi[2] );
+    quartic.getRoot3( wr[3], wi[3] );
+    nr = cache.quartic( r[0], r[1], r[2], r[3], r[4], zr, zi );
+    if ( nr != quartic.numRoots() || !same_roots( zr, zi, wr, wi, nr, 1 ) ) ++nbad;
+
+    rescale( r, 4, 8, 8, q );
+    nr = cache.quartic( q[0], q[1], q[2], q[3], q[4], zr, zi );
+    if ( nr != quartic.numRoots() || !same_roots( zr, zi, wr, wi, nr, 8 ) ) ++nbad;
+
+    // Jenkins-Traub roots are compared with the first solve through the cache
+    int ok = cache.roots( s, 7, wr, wi );
+    rescale( s, 7, 0.5, 2, q );
+    if ( ok != 0 || cache.roots( q, 7, zr, zi ) != 0 || !same_roots( zr, zi, wr, wi, 7, 2 ) ) ++nbad;
+  }
+}
+
+int
+main() {
+  PolySet set;
+  bool    ok = true;
+
+  // shared cache large enough for all the polynomials
+  RootsCache cache( 3*npoly );
+  vector<indexType>   nbad( nthreads );
+  vector<std::thread> threads;
+  for ( indexType t = 0; t < nthreads; ++t )
+    threads.push_back( std::thread( worker, std::ref(cache), std::cref(set), t, std::ref(nbad[t]) ) );
+  for ( indexType t = 0; t < nthreads; ++t ) threads[size_t(t)].join();
+  for ( indexType t = 0; t < nthreads; ++t ) ok = ok && nbad[t] == 0;
+
+  RootsCacheStats st = cache.getStats();
+  cout << "hits = " << st.hits << " misses = " << st.misses
+       << " evictions = " << st.evictions << " size = " << st.size << '\n';
+  ok = ok && st.misses == 3*npoly && st.hits == 3*npoly &&
+       st.evictions == 0 && st.size == 3*npoly;
+
+  // a small cache: repeated polynomials are found, the others are evicted
+  RootsCache small( 8 );
+  valueType  zr[4], zi[4];
+  for ( indexType i = 0; i < npoly; ++i ) {
+    valueType const * r = &set.quartic[5*(i%4)]; // hot set, always kept
+    small.quartic( r[0], r[1], r[2], r[3], r[4], zr, zi );
+    r = &set.quartic[5*i];
+    small.quartic( r[0], r[1], r[2], r[3], r[4], zr, zi );
+  }
+  st = small.getStats();
+  cout << "small cache hits = " << st.hits << " misses = " << st.misses
+       << " evictions = " << st.evictions << " size = " << st.size << '\n';
+  ok = ok && st.size == 8 && st.evictions == st.misses-8 && st.hits == npoly;
+
+  // x^3 and zero leading coefficient are not normalized
+  small.clear();
+  small.cubic( 1, 0, 0, 0, zr, zi );
+  small.quartic( 0, 1, -3, 2, 0, zr, zi );
+  st = small.getStats();
+  ok = ok && st.bypassed == 2 && st.size == 0 && st.hits == 0;
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/*
+.. This program counts the real roots of polynomials with known roots in
+.. random intervals by the Sturm sequences and compares the counts with the
+.. roots, also with multiple roots and for the batch functions of the cubics
+.. and quartics.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+static
+valueType
+uniform( valueType a, valueType b ) {
+  return a + (b-a)*valueType(rand())/RAND_MAX;
+}
+
+// coefficients (leading first) of the monic polynomial with the real
+// roots r[] and the complex roots re[k] +/- I*im[k]
+static
+vector<valueType>
+fromRoots( vector<valueType> const & r,
+           vector<valueType> const & re,
+           vector<valueType> const & im ) {
+  vector<valueType> p( 1, 1 );
+  for ( size_t k = 0; k < r.size(); ++k ) {
+    p.push_back(0);
+    for ( size_t i = p.size()-1; i > 0; --i ) p[i] -= r[k]*p[i-1];
+  }
+  for ( size_t k = 0; k < re.size(); ++k ) {
+    vector<valueType> q( p.size()+2, 0 );
+    valueType b = -2*re[k], c = re[k]*re[k]+im[k]*im[k];
+    for ( size_t i = 0; i < p.size(); ++i ) {
+      q[i]   += p[i];
+      q[i+1] += b*p[i];
+      q[i+2] += c*p[i];
+    }
+    p.swap(q);
+  }
+  return p;
+}
+
+// random polynomial of the given degree with distinct real roots in [-2,2]
+static
+vector<valueType>
+randomPoly( indexType degree, vector<valueType> & r ) {
+  vector<valueType> re, im;
+  bool distinct;
+  do {
+    r.clear(); re.clear(); im.clear();
+    indexType ncplx = 2*(rand() % (degree/2+1));
+    for ( indexType k = 0; k < ncplx/2; ++k ) {
+      re.push_back( uniform(-2,2) );
+      im.push_back( uniform(0.1,1) );
+    }
+    for ( indexType k = ncplx; k < degree; ++k ) r.push_back( uniform(-2,2) );
+    distinct = true;
+    for ( size_t i = 0; i < r.size(); ++i )
+      for ( size_t j = 0; j < i; ++j )
+        distinct = distinct && abs(r[i]-r[j]) > 1e-2;
+  } while ( !distinct );
+  return fromRoots( r, re, im );
+}
+
+// number of roots in (a,b], false if a root is too close to a or b
+static
+bool
+exactCount( vector<valueType> const & r, valueType a, valueType b, indexType & n ) {
+  n = 0;
+  for ( size_t i = 0; i < r.size(); ++i ) {
+    if ( abs(r[i]-a) < 1e-6 || abs(r[i]-b) < 1e-6 ) return false;
+    if ( r[i] > a && r[i] <= b ) ++n;
+  }
+  return true;
+}
+
+int
+main() {
+  bool ok = true;
+
+  // (x-1)*(x-2)*(x-3)*(x-4)*(x-5)
+  valueType p5[] = { 1, -15, 85, -225, 274, -120 };
+  Sturm s5( p5, 5 );
+  ok = ok && s5.countRealRoots() == 5 &&
+       s5.countRoots( 0, 6 ) == 5 && s5.countRoots( 1.5, 3.5 ) == 2 &&
+       s5.countRoots( 0, 1 ) == 1 && s5.countRoots( 1, 2 ) == 1 &&
+       s5.countRoots( 5.5, 10 ) == 0 && s5.countRoots( 3, 3 ) == 0 &&
+       countRealRoots( p5, 5, valueType(2.9), valueType(3.1) ) == 1;
+  if ( !ok ) cout << "failed on (x-1)*...*(x-5)\n";
+
+  // (x-1)^3*(x+2)^2*(x^2+1): the distinct roots are counted
+  vector<valueType> r, re, im;
+  r.push_back(1); r.push_back(1); r.push_back(1); r.push_back(-2); r.push_back(-2);
+  re.push_back(0); im.push_back(1);
+  vector<valueType> pm = fromRoots( r, re, im );
+  Sturm sm( &pm.front(), 7 );
+  bool okm = sm.countRealRoots() == 2 && sm.countRoots( 0, 2 ) == 1 &&
+             sm.countRoots( -3, 3 ) == 2 && sm.countRoots( -1, 0.5 ) == 0;
+  if ( !okm ) cout << "failed on (x-1)^3*(x+2)^2*(x^2+1)\n";
+  ok = ok && okm;
+
+  // random polynomials of degree 2 to 10, mostly short intervals
+  srand(2468);
+  indexType ntest = 0, nroots = 0, nbad = 0;
+  for ( indexType k = 0; k < 2000; ++k ) {
+    indexType degree = 2 + k % 9;
+    vector<valueType> p = randomPoly( degree, r );
+    Sturm sturm( &p.front(), degree );
+    if ( sturm.countRealRoots() != indexType(r.size()) ) ++nbad;
+    for ( indexType j = 0; j < 10; ++j ) {
+      valueType a = uniform(-3,3);
+      valueType b = a + ( j < 8 ? uniform(0,0.1) : uniform(0,4) );
+      indexType n;
+      if ( !exactCount( r, a, b, n ) ) continue;
+      ++ntest;
+      if ( n > 0 ) ++nroots;
+      if ( sturm.countRoots( a, b ) != n ) ++nbad;
+      if ( countRealRoots( &p.front(), degree, a, b ) != n ) ++nbad;
+    }
+  }
+  cout << "intervals = " << ntest << " with roots = " << nroots
+       << " wrong counts = " << nbad << '\n';
+  ok = ok && nbad == 0;
+
+  // batch of cubics and quartics, the same counts of countRealRoots
+  indexType const nb = 4000;
+  vector<valueType> A(nb), B(nb), C(nb), D(nb), E(nb), a(nb), b(nb);
+  vector<indexType> count(nb);
+  for ( indexType degree = 3; degree <= 4; ++degree ) {
+    indexType nonzero = 0, nbatch = 0;
+    for ( indexType i = 0; i < nb; ++i ) {
+      vector<valueType> p = randomPoly( degree, r );
+      A[i] = p[0]; B[i] = p[1]; C[i] = p[2]; D[i] = p[3]; E[i] = degree == 4 ? p[4] : 0;
+      a[i] = uniform(-3,3);
+      b[i] = a[i] + uniform(0,0.2);
+    }
+    if ( degree == 3 )
+      nbatch = countCubicRootsBatch( nb, &A.front(), &B.front(), &C.front(), &D.front(),
+                                     &a.front(), &b.front(), &count.front() );
+    else
+      nbatch = countQuarticRootsBatch( nb, &A.front(), &B.front(), &C.front(), &D.front(),
+                                       &E.front(), &a.front(), &b.front(), &count.front() );
+    for ( indexType i = 0; i < nb; ++i ) {
+      valueType p[] = { A[i], B[i], C[i], D[i], E[i] };
+      if ( count[i] != countRealRoots( p, degree, a[i], b[i] ) ) ok = false;
+      if ( count[i] > 0 ) ++nonzero;
+    }
+    cout << "degree " << degree << " batch intervals with roots = " << nbatch << '\n';
+    ok = ok && nbatch == nonzero;
+  }
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
@@ -45,6 +45,50 @@ do_test( double const p[3] ) {
   }
 }
 
+// special cases of findRoots, solved in the batch with the examples
+static double qspecial[][3] = {
+  {  0,  0,  1 },
+  {  0,  2,  1 },
+  {  2,  0,  0 },
+  {  2,  3,  0 },
+  {  2, -3,  0 },
+  {  1, -2,  1 },
+  {  1,  0, -4 },
+  { -3,  1,  2 }
+};
+
+// solve all the quadratics in a single call and compare with class Quadratic
+static
+bool
+do_test_batch() {
+  int const NQ = sizeof(qq)/sizeof(qq[0]);
+  int const NS = sizeof(qspecial)/sizeof(qspecial[0]);
+  int const N  = 4*(NQ+NS); // more than a block of the batch solver
+  double A[N], B[N], C[N], r0[N], r1[N];
+  int    nrts[N];
+  bool   cplx[N], dblx[N];
+  for ( int k = 0; k < N; ++k ) {
+    int j = k % (NQ+NS);
+    double const * p = j < NQ ? qq[j] : qspecial[j-NQ];
+    A[k] = p[0];
+    B[k] = p[1];
+    C[k] = p[2];
+  }
+  solveQuadraticBatch( N, A, B, C, r0, r1, nrts, cplx, dblx );
+  bool ok = true;
+  for ( int k = 0; k < N; ++k ) {
+    Quadratic qsolve( A[k], B[k], C[k] );
+    bool okk = nrts[k] == qsolve.numRoots()     &&
+               cplx[k] == qsolve.complexRoots() &&
+               dblx[k] == qsolve.doubleRoot()   &&
+               r0[k]   == qsolve.real_root0()   &&
+               r1[k]   == qsolve.real_root1();
+    if ( !okk ) cout << "batch mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  return ok;
+}
+
 int
 main() {
   cout.precision(20);
@@ -52,6 +96,7 @@ main() {
     cout << "\n\nExample N." << k << '\n';
     do_test(qq[k]);
   }
+  cout << "\n\nBatch solver " << (do_test_batch()?"OK!":"Failed!") << '\n';
   cout << "\n\nALL DONE!\n";
   return 0;
 }
@@ -12,6 +12,9 @@
 #include "PolynomialRoots.hh"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <limits>
+#include <cstdlib>
 
 using namespace std;
 using namespace PolynomialRoots;
@@ -88,10 +91,172 @@ do_test(
   }
 }
 
+static double const * cubics[] = {
+  cubic1, cubic2, cubic3,  cubic4,  cubic5,  cubic6,
+  cubic7, cubic8, cubic9, cubic10, cubic11, cubic12
+};
+
+// solve all the cubics in a single call and compare with class Cubic
+static
+bool
+do_test_batch() {
+  int const N = sizeof(cubics)/sizeof(cubics[0]);
+  double A[N], B[N], C[N], D[N];
+  double r0[N], r1[N], r2[N];
+  int    nrts[N];
+  bool   cplx[N], dblx[N], trpx[N];
+  for ( int k = 0; k < N; ++k ) {
+    A[k] = cubics[k][0];
+    B[k] = cubics[k][1];
+    C[k] = cubics[k][2];
+    D[k] = cubics[k][3];
+  }
+  solveCubicBatch( N, A, B, C, D, r0, r1, r2, nrts, cplx, dblx, trpx );
+  bool ok = true;
+  for ( int k = 0; k < N; ++k ) {
+    Cubic csolve( A[k], B[k], C[k], D[k] );
+    bool okk = nrts[k] == csolve.numRoots()     &&
+               cplx[k] == csolve.complexRoots() &&
+               trpx[k] == csolve.tripleRoot()   &&
+               r0[k]   == csolve.real_root0()   &&
+               r1[k]   == csolve.real_root1()   &&
+               r2[k]   == csolve.real_root2();
+    if ( !okk ) cout << "batch mismatch on test N." << k+1 << '\n';
+    ok = ok && okk;
+  }
+  return ok;
+}
+
+// a NaN coefficient made the Newton iteration loop forever: the class and
+// the batch must return, with the same kind of roots
+static
+bool
+do_test_nan() {
+  double A[] = { 1, 1 };
+  double B[] = { 0, -3.000003 };
+  double C[] = { 0, 3.000006000002 };
+  double D[] = { numeric_limits<double>::quiet_NaN(), -1.000003000002 };
+  double r0[2], r1[2], r2[2];
+  int    nrts[2];
+  bool   cplx[2], dblx[2], trpx[2];
+  solveCubicBatch( 2, A, B, C, D, r0, r1, r2, nrts, cplx, dblx, trpx );
+  Cubic csolve( A[0], B[0], C[0], D[0] );
+  return nrts[0] == csolve.numRoots() && cplx[0] == csolve.complexRoots() &&
+         r0[1] == Cubic( A[1], B[1], C[1], D[1] ).real_root0();
+}
+
 #define DO_TEST( N ) \
   cout << "\n\nText N." << N << '\n'; \
   do_test( cubic##N, rootCubicReal##N, rootCubicImag##N )
 
+// smallest root in an interval, compare with the roots computed by class Cubic
+static
+bool
+do_test_interval() {
+  srand(1234);
+  bool ok = true;
+  for ( int k = 0; k < 10000 && ok; ++k ) {
+    double r = 20*double(rand())/RAND_MAX-10;
+    double b = 20*double(rand())/RAND_MAX-10; // x^2 + b*x + c
+    double c = 20*double(rand())/RAND_MAX-10;
+    double lo = 20*double(rand())/RAND_MAX-10;
+    double hi = lo+10*double(rand())/RAND_MAX;
+    // (x-r)*(x^2+b*x+c)
+    Cubic csolve( 1, b-r, c-b*r, -c*r );
+    double rr[3], expected = 0, x;
+    int    nr    = csolve.getRealRoots( rr );
+    bool   found = false;
+    for ( int i = 0; i < nr && !found; ++i )
+      if ( rr[i] >= lo && rr[i] <= hi ) { expected = rr[i]; found = true; }
+    bool okk = solveCubicInterval( 1.0, b-r, c-b*r, -c*r, lo, hi, x ) == found;
+    if ( found && okk ) okk = std::abs(x-expected) <= 1e-8*(1+std::abs(expected));
+    if ( !okk ) cout << "interval mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  double x;
+  ok = ok && !solveCubicInterval( 1.0, 0.0, 0.0, -1.0, 2.0, 3.0, x ); // root 1 outside
+  ok = ok && solveCubicInterval( 1.0, -3.0, 3.0, -1.0, 0.0, 2.0, x ) && std::abs(x-1) < 1e-5; // triple root
+  return ok;
+}
+
+// a slowly changing cubic solved by update, the roots cross from
+// real to complex and back: the roots must be as good as the ones of setup
+static
+bool
+do_test_warm() {
+  Cubic     warm, cold;
+  indexType warmIter = 0, coldIter = 0, warmOk = 0, coldOk = 0;
+  bool      ok = true;
+  ostringstream null;
+  for ( int k = 0; k < 10000 && ok; ++k ) {
+    double t = k*1e-3;
+    double r = 3*std::sin(t);
+    double b = 2*std::cos(0.7*t);      // x^2 + b*x + c
+    double c = 1.5*std::sin(0.3*t+1);
+    // (x-r)*(x^2+b*x+c)
+    double B = b-r, C = c-b*r, D = -c*r;
+    warm.update( 1, B, C, D );
+    cold.setup( 1, B, C, D );
+    warmIter += warm.numIter();
+    coldIter += cold.numIter();
+    bool wok = warm.check( null );
+    bool cok = cold.check( null );
+    if ( wok ) ++warmOk;
+    if ( cok ) ++coldOk;
+    // the kind of roots may differ only where setup fails
+    bool okk = ( warm.numRoots() == cold.numRoots() &&
+                 warm.complexRoots() == cold.complexRoots() ) || ( wok && !cok );
+    if ( !okk ) cout << "warm start mismatch on step N." << k << '\n';
+    ok = okk;
+  }
+  // the roots pass the check at least as often, with less than
+  // half of the iterations (fewer than the Halley iterations from the
+  // table, which start almost as close)
+  #ifdef POLYNOMIAL_ROOTS_CUBIC_TABLE
+  return ok && warmOk >= coldOk && warmIter < coldIter;
+  #else
+  return ok && warmOk >= coldOk && 2*warmIter < coldIter;
+  #endif
+}
+
+// closed form roots of the test cubics and of random cubics: the roots
+// must pass the check as often as the ones of setup, the near multiple
+// roots of the test cubics fall back to setup
+static
+bool
+do_test_closed_form() {
+  int const NC = sizeof(cubics)/sizeof(cubics[0]);
+  srand(4321);
+  ostringstream null;
+  bool ok = true;
+  int  npass = 0, npassClosed = 0;
+  for ( int k = 0; k < 10000+NC; ++k ) {
+    double A = 1, B, C, D;
+    if ( k < NC ) {
+      A = cubics[k][0]; B = cubics[k][1]; C = cubics[k][2]; D = cubics[k][3];
+    } else {
+      double r = 20*double(rand())/RAND_MAX-10;
+      double b = 20*double(rand())/RAND_MAX-10; // (x-r)*(x^2+b*x+c)
+      double c = 20*double(rand())/RAND_MAX-10;
+      B = b-r; C = c-b*r; D = -c*r;
+    }
+    Cubic closed, cold;
+    closed.setupClosedForm( A, B, C, D );
+    cold.setup( A, B, C, D );
+    bool wok = closed.check( null );
+    bool cok = cold.check( null );
+    if ( wok ) ++npassClosed;
+    if ( cok ) ++npass;
+    // the kind of roots may differ only at a double root or where one of the two fails
+    bool okk = ( closed.numRoots() == cold.numRoots() &&
+                 closed.complexRoots() == cold.complexRoots() ) ||
+               closed.doubleRoot() || cold.doubleRoot() || !wok || !cok;
+    if ( !okk ) cout << "closed form mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  return ok && npassClosed >= npass;
+}
+
 int
 main() {
   cout.precision(18);
@@ -107,6 +272,11 @@ main() {
   DO_TEST(10);
   DO_TEST(11);
   DO_TEST(12);
+  cout << "\n\nBatch solver " << (do_test_batch()?"OK!":"Failed!") << '\n';
+  cout << "\n\nNaN coefficient " << (do_test_nan()?"OK!":"Failed!") << '\n';
+  cout << "\n\nInterval solver " << (do_test_interval()?"OK!":"Failed!") << '\n';
+  cout << "\n\nWarm start " << (do_test_warm()?"OK!":"Failed!") << '\n';
+  cout << "\n\nClosed form " << (do_test_closed_form()?"OK!":"Failed!") << '\n';
   cout << "\n\nALL DONE!\n";
   return 0;
 }
@@ -6,6 +6,9 @@
 #include "PolynomialRoots.hh"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <limits>
+#include <cstdlib>
 
 using namespace std;
 using namespace PolynomialRoots;
@@ -129,6 +132,253 @@ do_test(
   }
 }
 
+static double const * quartics[] = {
+  quartic0,  quartic1,  quartic2,  quartic3,  quartic4,
+  quartic5,  quartic6,  quartic7,  quartic8,  quartic9,
+  quartic10, quartic11, quartic12, quartic13, quartic14,
+  quartic15, quartic16, quartic17, quartic18
+};
+
+// solve all the quartics in a single call and compare with class Quartic,
+// followed by products (x^2+p1*x+q1)*(x^2+p2*x+q2) with only complex roots
+static
+bool
+do_test_batch() {
+  int const NQ = sizeof(quartics)/sizeof(quartics[0]);
+  int const N  = NQ + 100;
+  double A[N], B[N], C[N], D[N], E[N];
+  double r0[N], r1[N], r2[N], r3[N];
+  int    nreal[N], ncplx[N];
+  for ( int k = 0; k < NQ; ++k ) {
+    A[k] = quartics[k][0];
+    B[k] = quartics[k][1];
+    C[k] = quartics[k][2];
+    D[k] = quartics[k][3];
+    E[k] = quartics[k][4];
+  }
+  srand(1234);
+  for ( int k = NQ; k < N; ++k ) {
+    double p1 = 4*double(rand())/RAND_MAX-2, q1 = p1*p1/4 + double(rand())/RAND_MAX;
+    double p2 = 4*double(rand())/RAND_MAX-2, q2 = p2*p2/4 + double(rand())/RAND_MAX;
+    A[k] = 1;
+    B[k] = p1+p2;
+    C[k] = q1+q2+p1*p2;
+    D[k] = p1*q2+p2*q1;
+    E[k] = q1*q2;
+  }
+  solveQuarticBatch( N, A, B, C, D, E, r0, r1, r2, r3, nreal, ncplx );
+  bool ok = true;
+  for ( int k = 0; k < N; ++k ) {
+    Quartic qsolve( A[k], B[k], C[k], D[k], E[k] );
+    bool okk = nreal[k] == qsolve.numRealRoots()    &&
+               ncplx[k] == qsolve.numComplexRoots() &&
+               r0[k]    == qsolve.real_root0()      &&
+               r1[k]    == qsolve.real_root1()      &&
+               ( nreal[k]+ncplx[k] < 3 || r2[k] == qsolve.real_root2() ) &&
+               ( nreal[k]+ncplx[k] < 4 || r3[k] == qsolve.real_root3() );
+    if ( !okk ) cout << "batch mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  return ok;
+}
+
+// clustered roots where Newton loops did not terminate: an exact double
+// root at the starting point (p = dp = 0) and a hexic Newton iteration that
+// never converges. The roots must be finite and the batch must match.
+static
+bool
+do_test_clustered() {
+  int const N = 2;
+  double A[N] = { 1, 1 };
+  double B[N] = { -21.7041117661093,   -16.822797298458777 };
+  double C[N] = { 176.65067527320207,  106.12744084177056 };
+  double D[N] = { -639.00766617911802, -297.56007077679931 };
+  double E[N] = { 866.81836199820259,  312.86204706299281 };
+  double r0[N], r1[N], r2[N], r3[N];
+  int    nreal[N], ncplx[N];
+  solveQuarticBatch( N, A, B, C, D, E, r0, r1, r2, r3, nreal, ncplx );
+  bool ok = true;
+  for ( int k = 0; k < N; ++k ) {
+    Quartic qsolve( A[k], B[k], C[k], D[k], E[k] );
+    bool okk = qsolve.numRoots() == 4 &&
+               abs(qsolve.real_root0()) < 1e3 && abs(qsolve.real_root1()) < 1e3 &&
+               abs(qsolve.real_root2()) < 1e3 && abs(qsolve.real_root3()) < 1e3 &&
+               nreal[k] == qsolve.numRealRoots()    &&
+               ncplx[k] == qsolve.numComplexRoots() &&
+               r0[k] == qsolve.real_root0() && r1[k] == qsolve.real_root1() &&
+               r2[k] == qsolve.real_root2() && r3[k] == qsolve.real_root3();
+    if ( !okk ) cout << "clustered roots mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  return ok;
+}
+
+// the ill conditioned quartics 2 and 18 (clustered and close roots): the
+// roots of class Quartic polished by polishRootC must match the roots
+// computed in long double and polished in long double to near full accuracy
+static
+bool
+do_test_polish() {
+  double const * tests[] = { quartic2, quartic18 };
+  bool ok = true;
+  for ( int k = 0; k < 2; ++k ) {
+    double const * p = tests[k];
+    long double    pl[5];
+    for ( int i = 0; i < 5; ++i ) pl[i] = p[i];
+    Quartic                  qsolve( p[0], p[1], p[2], p[3], p[4] );
+    QuarticT<long double>    qref( pl[0], pl[1], pl[2], pl[3], pl[4] );
+    complexType              r[4]   = { qsolve.root0(), qsolve.root1(), qsolve.root2(), qsolve.root3() };
+    complex<long double>     ref[4] = { qref.root0(), qref.root1(), qref.root2(), qref.root3() };
+    for ( int i = 0; i < 4; ++i ) ref[i] = polishRootC( pl, 4, ref[i] );
+    for ( int i = 0; i < 4; ++i ) {
+      // a double real root may be a pair of complex roots, the complex step finds one of them
+      complexType z = polishRootC( p, 4, r[i] );
+      long double err = numeric_limits<long double>::max();
+      for ( int j = 0; j < 4; ++j )
+        err = min( err, abs( complex<long double>(z.real(),z.imag()) - ref[j] ) / abs(ref[j]) );
+      bool okk = err <= 100*numeric_limits<double>::epsilon();
+      if ( !okk ) cout << "polished root " << z << " of test N." << (k == 0 ? 2 : 18)
+                       << " relative error = " << double(err) << '\n';
+      ok = ok && okk;
+    }
+    // the real roots are refined in real arithmetic
+    double rr[4];
+    int nr = qsolve.getRealRoots( rr );
+    for ( int i = 0; i < nr; ++i ) {
+      double z = polishRoot( p, 4, rr[i] );
+      ok = ok && abs( compHorner( p, 4, z ) ) <= abs( compHorner( p, 4, rr[i] ) );
+    }
+  }
+  return ok;
+}
+
+// real roots only, compare with class Quartic and check the quartics with no real roots
+static
+bool
+do_test_real() {
+  int const N = sizeof(quartics)/sizeof(quartics[0]);
+  bool ok = true;
+  for ( int k = 0; k < N; ++k ) {
+    double const * p = quartics[k];
+    Quartic qsolve( p[0], p[1], p[2], p[3], p[4] );
+    double r[4], rq[4];
+    int nr  = solveQuarticReal( p[0], p[1], p[2], p[3], p[4], r );
+    int nrq = qsolve.getRealRoots( rq );
+    bool okk = nr == qsolve.numRealRoots() && nr <= nrq;
+    for ( int i = 0; i < nr && okk; ++i ) okk = r[i] == rq[i];
+    if ( !okk ) cout << "real roots mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  // (x^2+1)*(x^2+4), (x^2+2*x+2)*(x^2-2*x+5) and (x^2+1)^2
+  double const cplx[][5] = { { 1, 0, 5, 0, 4 }, { 1, 0, 3, -6, 10 }, { 1, 0, 2, 0, 1 } };
+  for ( int k = 0; k < 3; ++k ) {
+    double r[4];
+    ok = ok && solveQuarticReal( cplx[k][0], cplx[k][1], cplx[k][2], cplx[k][3], cplx[k][4], r ) == 0;
+  }
+  return ok;
+}
+
+// smallest root in an interval, compare with the roots computed by class Quartic
+static
+bool
+do_test_interval() {
+  srand(1234);
+  bool ok = true;
+  for ( int k = 0; k < 10000 && ok; ++k ) {
+    double b1 = 20*double(rand())/RAND_MAX-10; // x^2 + b1*x + c1
+    double c1 = 20*double(rand())/RAND_MAX-10;
+    double b2 = 20*double(rand())/RAND_MAX-10; // x^2 + b2*x + c2
+    double c2 = 20*double(rand())/RAND_MAX-10;
+    double lo = 20*double(rand())/RAND_MAX-10;
+    double hi = lo+10*double(rand())/RAND_MAX;
+    double p[] = { 1, b1+b2, c1+c2+b1*b2, b1*c2+b2*c1, c1*c2 };
+    Quartic qsolve( p[0], p[1], p[2], p[3], p[4] );
+    double rr[4], expected = 0, x;
+    int    nr    = qsolve.getRealRoots( rr );
+    bool   found = false;
+    for ( int i = 0; i < nr && !found; ++i )
+      if ( rr[i] >= lo && rr[i] <= hi ) { expected = rr[i]; found = true; }
+    bool okk = solveQuarticInterval( p[0], p[1], p[2], p[3], p[4], lo, hi, x ) == found;
+    if ( found && okk ) okk = std::abs(x-expected) <= 1e-8*(1+std::abs(expected));
+    if ( !okk ) cout << "interval mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  double x;
+  ok = ok && !solveQuarticInterval( 1.0, 0.0, 5.0, 0.0, 4.0, -10.0, 10.0, x ); // no real roots
+  ok = ok && solveQuarticInterval( 1.0, -10.0, 35.0, -50.0, 24.0, 1.5, 10.0, x ) && std::abs(x-2) < 1e-12;
+  ok = ok && solveQuarticInterval( 1.0, 0.0, -2.0, 0.0, 1.0, -0.5, 2.0, x ) && std::abs(x-1) < 1e-7; // (x^2-1)^2
+  return ok;
+}
+
+// a slowly changing quartic solved by update, the pairs of roots cross
+// from real to complex and back: the roots must be as good as the ones of setup
+static
+bool
+do_test_warm() {
+  Quartic   warm, cold;
+  indexType warmIter = 0, coldIter = 0, warmOk = 0, coldOk = 0;
+  bool      ok = true;
+  ostringstream null;
+  for ( int k = 0; k < 10000 && ok; ++k ) {
+    double t  = k*1e-3;
+    double b1 = 3*std::sin(t);       // x^2 + b1*x + c1
+    double c1 = 2*std::cos(0.7*t);
+    double b2 = 2*std::cos(0.4*t+2); // x^2 + b2*x + c2
+    double c2 = 1.5*std::sin(0.3*t+1)+0.5;
+    // (x^2+b1*x+c1)*(x^2+b2*x+c2)
+    double B = b1+b2, C = c1+c2+b1*b2, D = b1*c2+b2*c1, E = c1*c2;
+    warm.update( 1, B, C, D, E );
+    cold.setup( 1, B, C, D, E );
+    warmIter += warm.numIter();
+    coldIter += cold.numIter();
+    bool wok = warm.check( null );
+    bool cok = cold.check( null );
+    if ( wok ) ++warmOk;
+    if ( cok ) ++coldOk;
+    // the kind of roots may differ only where setup fails
+    bool okk = ( warm.numRoots() == cold.numRoots() &&
+                 warm.numComplexRoots() == cold.numComplexRoots() ) || ( wok && !cok );
+    if ( !okk ) cout << "warm start mismatch on step N." << k << '\n';
+    ok = okk;
+  }
+  // the roots pass the check at least as often, with less than
+  // half of the iterations
+  return ok && warmOk >= coldOk && 2*warmIter < coldIter;
+}
+
+// closed form roots of the test quartics and of random quartics: the
+// roots must pass the check as often as the ones of setup
+static
+bool
+do_test_closed_form() {
+  int const NQ = sizeof(quartics)/sizeof(quartics[0]);
+  srand(4321);
+  ostringstream null;
+  bool ok = true;
+  int  npass = 0, npassClosed = 0;
+  for ( int k = 0; k < 10000+NQ; ++k ) {
+    double p[5];
+    if ( k < NQ ) {
+      for ( int i = 0; i < 5; ++i ) p[i] = quartics[k][i];
+    } else {
+      for ( int i = 0; i < 5; ++i ) p[i] = 2*double(rand())/RAND_MAX-1;
+    }
+    Quartic closed, cold;
+    closed.setupClosedForm( p[0], p[1], p[2], p[3], p[4] );
+    cold.setup( p[0], p[1], p[2], p[3], p[4] );
+    bool wok = closed.check( null );
+    bool cok = cold.check( null );
+    if ( wok ) ++npassClosed;
+    if ( cok ) ++npass;
+    // the kind of roots may differ only where one of the two fails
+    bool okk = ( closed.numRoots() == cold.numRoots() &&
+                 closed.numComplexRoots() == cold.numComplexRoots() ) || !wok || !cok;
+    if ( !okk ) cout << "closed form mismatch on test N." << k << '\n';
+    ok = ok && okk;
+  }
+  return ok && npassClosed >= npass;
+}
+
 int
 main() {
   cout.precision(14);
@@ -153,6 +403,13 @@ main() {
   DO_TEST(16);
   DO_TEST(17);
   DO_TEST(18);
+  cout << "\n\nBatch solver " << (do_test_batch()?"OK!":"Failed!") << '\n';
+  cout << "\n\nClustered roots " << (do_test_clustered()?"OK!":"Failed!") << '\n';
+  cout << "\n\nPolished roots " << (do_test_polish()?"OK!":"Failed!") << '\n';
+  cout << "\n\nReal roots solver " << (do_test_real()?"OK!":"Failed!") << '\n';
+  cout << "\n\nInterval solver " << (do_test_interval()?"OK!":"Failed!") << '\n';
+  cout << "\n\nWarm start " << (do_test_warm()?"OK!":"Failed!") << '\n';
+  cout << "\n\nClosed form " << (do_test_closed_form()?"OK!":"Failed!") << '\n';
   cout << "\n\nALL DONE!\n";
   return 0;
 }
@@ -0,0 +1,122 @@
+/*
+.. This program solves the same set of quadratic, cubic and quartic
+.. polynomials with the solvers instantiated in float, double, long double
+.. and (when enabled) quad precision and checks that the errors on the roots
+.. scale with the machine epsilon of the type.
+*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-Utils.hh"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+// tolerance on the roots, in multiples of the machine epsilon
+static double const tolerance = 1000;
+
+template <typename Real>
+static
+bool
+check_root( char const * what, Real x, Real y, Real exact_x, Real exact_y ) {
+  Real err = abs(complex<Real>(x-exact_x,y-exact_y)) /
+             (1+abs(complex<Real>(exact_x,exact_y)));
+  bool ok = err <= Real(tolerance) * machineEpsilon<Real>();
+  if ( !ok )
+    cout << what << " root (" << double(exact_x) << "," << double(exact_y)
+         << ") relative error = " << double(err) << '\n';
+  return ok;
+}
+
+template <typename Real>
+static
+bool
+do_test( char const * name ) {
+  bool ok = true;
+  ostringstream null;
+
+  // (x-1)*(x-2)
+  QuadraticT<Real> q( 1, -3, 2 );
+  ok = ok && q.numRoots() == 2 && !q.complexRoots();
+  ok = check_root<Real>( "quadratic", q.real_root0(), 0, 1, 0 ) && ok;
+  ok = check_root<Real>( "quadratic", q.real_root1(), 0, 2, 0 ) && ok;
+
+  // (x-1)*(x^2+1)
+  CubicT<Real> c( 1, -1, 1, -1 );
+  ok = ok && c.numRoots() == 3 && c.complexRoots();
+  ok = check_root<Real>( "cubic", c.real_root2(), 0, 1, 0 ) && ok;
+  ok = check_root<Real>( "cubic", c.real_root0(), abs(c.real_root1()), 0, 1 ) && ok;
+
+  // (x-1)*(x-2)*(x-3)*(x-4)
+  QuarticT<Real> r( 1, -10, 35, -50, 24 );
+  Real rr[4];
+  ok = ok && r.numRoots() == 4 && r.getRealRoots( rr ) == 4;
+  for ( indexType i = 0; i < 4 && ok; ++i )
+    ok = check_root<Real>( "quartic", rr[i], 0, Real(i+1), 0 ) && ok;
+  ok = r.check( null ) && ok;
+
+  // (x^2+1)*(x^2+4)
+  QuarticT<Real> z( 1, 0, 5, 0, 4 );
+  ok = ok && z.numRoots() == 4 && z.numComplexRoots() == 4;
+  ok = z.check( null ) && ok;
+
+  // Jenkins-Traub: (x-1)*(x-2)*(x-3)*(x-4)*(x-5)
+  Real op[] = { 1, -15, 85, -225, 274, -120 };
+  Real zr[5], zi[5];
+  ok = ok && roots( op, 5, zr, zi ) == 0;
+  for ( indexType i = 0; i < 5 && ok; ++i ) {
+    Real exact = Real(std::floor(double(zr[i])+0.5));
+    ok = check_root<Real>( "Jenkins-Traub", zr[i], zi[i], exact, 0 ) && ok;
+  }
+
+  // polishing of the perturbed roots with the compensated Horner scheme
+  for ( indexType i = 0; i < 5 && ok; ++i ) {
+    Real exact = Real(i+1);
+    Real x     = polishRoot( op, 5, exact*(1+1000*machineEpsilon<Real>()) );
+    ok = check_root<Real>( "polished", x, 0, exact, 0 ) && ok;
+    complex<Real> z = polishRootC( op, 5, complex<Real>( exact, Real(0.001) ) );
+    ok = check_root<Real>( "polished", z.real(), z.imag(), exact, 0 ) && ok;
+  }
+
+  // batch evaluation at points inside and outside [-1,1]
+  Real xs[41], ys[41];
+  for ( indexType i = 0; i <= 40; ++i ) xs[i] = Real(i-20)/4;
+  evalPoly( op, 5, xs, 41, ys );
+  for ( indexType i = 0; i <= 40 && ok; ++i ) {
+    Real bound = 0;
+    for ( indexType k = 0; k <= 5; ++k ) bound = bound * abs(xs[i]) + abs(op[k]);
+    ok = abs(ys[i]-evalPoly( op, 5, xs[i] )) <= Real(tolerance) * machineEpsilon<Real>() * bound;
+    if ( !ok ) cout << "batch evalPoly at x = " << double(xs[i]) << '\n';
+  }
+
+  // the same with complex points, ys[] is the imaginary part
+  for ( indexType i = 0; i <= 40; ++i ) ys[i] = Real(20-i)/8;
+  Real pr[41], pi[41];
+  evalPolyC( op, 5, xs, ys, 41, pr, pi );
+  for ( indexType i = 0; i <= 40 && ok; ++i ) {
+    complex<Real> x( xs[i], ys[i] );
+    Real bound = 0;
+    for ( indexType k = 0; k <= 5; ++k ) bound = bound * abs(x) + abs(op[k]);
+    ok = abs(complex<Real>(pr[i],pi[i])-evalPolyC( op, 5, x )) <=
+         Real(tolerance) * machineEpsilon<Real>() * bound;
+    if ( !ok ) cout << "batch evalPolyC at x = " << double(xs[i]) << "+I*" << double(ys[i]) << '\n';
+  }
+
+  cout << setw(12) << name << " epsilon = " << setw(13)
+       << double(machineEpsilon<Real>()) << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+int
+main() {
+  bool ok = do_test<float>( "float" );
+  ok = do_test<double>( "double" ) && ok;
+  ok = do_test<long double>( "long double" ) && ok;
+  #ifdef POLYNOMIAL_ROOTS_USE_FLOAT128
+  ok = do_test<__float128>( "__float128" ) && ok;
+  #endif
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+/*
+.. This program solves a set of polynomials of increasing degree with the
+.. Jenkins-Traub solver, reusing the same workspace for all the solves, and
+.. checks that the roots are the same computed without the workspace.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+static indexType const maxDegree = 20;
+
+// coefficients of (x-1)*(x-2)*...*(x-n)
+static
+void
+productPoly( indexType n, valueType op[] ) {
+  op[0] = 1;
+  for ( indexType k = 1; k <= n; ++k ) {
+    op[k] = 0;
+    for ( indexType i = k; i > 0; --i ) op[i] -= k*op[i-1];
+  }
+}
+
+static
+bool
+do_test( char const * name, valueType const op[], indexType degree, JenkinsTraubWorkspace & work ) {
+  valueType zr[maxDegree], zi[maxDegree], wr[maxDegree], wi[maxDegree];
+  int ok0 = roots( op, degree, zr, zi );
+  int ok1 = roots( work, op, degree, wr, wi );
+  bool ok = ok0 == ok1;
+  for ( indexType i = 0; i < degree && ok; ++i )
+    ok = zr[i] == wr[i] && zi[i] == wi[i];
+  valueType maxres = 0;
+  for ( indexType i = 0; i < degree; ++i ) {
+    valueType res = abs(evalPolyC( op, degree, complexType(wr[i],wi[i]) ));
+    if ( res > maxres ) maxres = res;
+  }
+  cout << setw(10) << name << " degree = " << setw(2) << degree
+       << " info = " << setw(2) << ok1
+       << " max |p(x)| = " << setw(12) << maxres
+       << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+// the roots of (x-1)*(x-2)*...*(x-n) must be 1, 2, ..., n: the last factor
+// left by the deflation is a cubic with three distinct real roots, which
+// are all stored (the third root was a copy of the second one)
+static
+bool
+do_test_distinct( indexType n ) {
+  valueType op[maxDegree+1], zr[maxDegree], zi[maxDegree];
+  productPoly( n, op );
+  bool ok = roots( op, n, zr, zi ) == 0;
+  sort( zr, zr+n );
+  for ( indexType i = 0; i < n && ok; ++i )
+    ok = abs(zr[i]-(i+1)) <= 1e-6 && zi[i] == 0;
+  cout << setw(10) << "distinct" << " degree = " << setw(2) << n
+       << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+// from x = 1/2 the Taylor quadratic of x^3 + x has no real root and
+// polishRoot takes a Newton step to 1/2 - p/p' = 1/7
+static
+bool
+do_test_newton_fallback() {
+  valueType const op[] = { 1, 0, 1, 0 };
+  valueType x = polishRoot( op, 3, valueType(0.5), 1 );
+  bool ok = abs(x-valueType(1)/7) <= 1e-15;
+  cout << setw(10) << "fallback" << " x = " << setw(10) << x
+       << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+// largest relative distance of the roots (zr,zi) from the nearest reference root
+static
+valueType
+rootsError(
+  indexType                         degree,
+  vector<valueType> const         & zr,
+  vector<valueType> const         & zi,
+  vector<long double> const       & rr,
+  vector<long double> const       & ri
+) {
+  long double maxerr = 0;
+  for ( indexType i = 0; i < degree; ++i ) {
+    long double err = numeric_limits<long double>::max();
+    for ( indexType j = 0; j < degree; ++j ) {
+      complex<long double> r( rr[j], ri[j] );
+      err = min( err, abs( complex<long double>(zr[i],zi[i]) - r ) / abs(r) );
+    }
+    maxerr = max( maxerr, err );
+  }
+  return valueType(maxerr);
+}
+
+// the roots polished on the undeflated polynomial must agree with the roots
+// computed and polished in long double to a few ulps
+static
+bool
+do_test_polish( indexType degree ) {
+  vector<valueType>   op(degree+1), zr(degree), zi(degree);
+  vector<long double> opl(degree+1), rr(degree), ri(degree);
+  for ( indexType i = 0; i <= degree; ++i ) opl[i] = op[i] = 2*valueType(rand())/RAND_MAX-1;
+  bool ok = roots( &op.front(), degree, &zr.front(), &zi.front() ) == 0 &&
+            roots( &opl.front(), degree, &rr.front(), &ri.front() ) == 0;
+  polishRoots( &opl.front(), degree, &rr.front(), &ri.front() );
+  valueType err0 = rootsError( degree, zr, zi, rr, ri );
+  indexType nstop = polishRoots( &op.front(), degree, &zr.front(), &zi.front() );
+  valueType err1 = rootsError( degree, zr, zi, rr, ri );
+  ok = ok && nstop == degree && err1 <= 100*numeric_limits<valueType>::epsilon();
+  cout << setw(10) << "polish" << " degree = " << setw(2) << degree
+       << " error = " << setw(10) << err0 << " -> " << setw(10) << err1
+       << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+// the roots of p + k*q tracked along the gains must agree with the roots
+// computed from scratch for each gain, with few full solves
+static
+bool
+do_test_locus( indexType degP, indexType degQ ) {
+  indexType const nk = 500;
+  indexType       n  = max(degP,degQ);
+  vector<valueType>   p(degP+1), q(degQ+1), k(nk), zr(nk*n), zi(nk*n);
+  vector<long double> op(n+1), rr(n), ri(n);
+  vector<indexType>   info(nk);
+  for ( indexType i = 0; i <= degP; ++i ) p[i] = 2*valueType(rand())/RAND_MAX-1;
+  for ( indexType i = 0; i <= degQ; ++i ) q[i] = 2*valueType(rand())/RAND_MAX-1;
+  for ( indexType j = 0; j < nk; ++j ) k[j] = valueType(j)/10;
+  indexType nfull = rootLocus( &p.front(), degP, &q.front(), degQ,
+                               &k.front(), nk, &zr.front(), &zi.front(), &info.front() );
+  bool      ok     = true;
+  valueType maxerr = 0;
+  for ( indexType j = 0; j < nk && ok; ++j ) {
+    for ( indexType i = 0; i <= n; ++i ) {
+      long double pi = i >= n-degP ? p[i-(n-degP)] : 0;
+      long double qi = i >= n-degQ ? q[i-(n-degQ)] : 0;
+      op[i] = pi + k[j]*qi;
+    }
+    ok = info[j] >= 0 && roots( &op.front(), n, &rr.front(), &ri.front() ) == 0;
+    polishRoots( &op.front(), n, &rr.front(), &ri.front() );
+    vector<valueType> xr( zr.begin()+j*n, zr.begin()+(j+1)*n );
+    vector<valueType> xi( zi.begin()+j*n, zi.begin()+(j+1)*n );
+    maxerr = max( maxerr, rootsError( n, xr, xi, rr, ri ) );
+  }
+  ok = ok && maxerr <= 1e-6 && 10*nfull < nk;
+  cout << setw(10) << "locus" << " degree = " << setw(2) << n
+       << " full solves = " << setw(3) << nfull << " error = " << setw(10) << maxerr
+       << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+int
+main() {
+  JenkinsTraubWorkspace work( maxDegree );
+  valueType op[maxDegree+1];
+  bool ok = true;
+
+  cout << setprecision(4);
+
+  for ( indexType n = 4; n <= 12; ++n ) {
+    productPoly( n, op );
+    ok = do_test( "product", op, n, work ) && ok;
+  }
+
+  srand(1234);
+  for ( indexType n = 5; n <= maxDegree; n += 3 ) {
+    for ( indexType i = 0; i <= n; ++i ) op[i] = 2*valueType(rand())/RAND_MAX-1;
+    ok = do_test( "random", op, n, work ) && ok;
+  }
+
+  // zeros at the origin are removed before the iteration
+  productPoly( 6, op );
+  op[7] = op[8] = 0;
+  ok = do_test( "origin", op, 8, work ) && ok;
+
+  // the workspace is too small
+  JenkinsTraubWorkspace small( 4 );
+  valueType zr[maxDegree], zi[maxDegree];
+  productPoly( 6, op );
+  ok = roots( small, op, 6, zr, zi ) == -3 && ok;
+
+  for ( indexType n = 3; n <= 8; ++n ) ok = do_test_distinct( n ) && ok;
+
+  ok = do_test_newton_fallback() && ok;
+  for ( indexType n = 20; n <= 40; n += 5 ) ok = do_test_polish( n ) && ok;
+
+  ok = do_test_locus( 8, 5 ) && ok;
+  ok = do_test_locus( 4, 3 ) && ok;
+  ok = do_test_locus( 12, 12 ) && ok;
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+.. This program solves a batch of random polynomials of mixed degree
+.. with the parallel batch solver and checks that the roots are the
+.. same computed by a single thread.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+int
+main() {
+  indexType const n         = 20000;
+  indexType const maxDegree = 40;
+
+  vector<indexType> degree(n), offset(n+1);
+  offset[0] = 0;
+  srand(1234);
+  for ( indexType i = 0; i < n; ++i ) {
+    // mostly low degree polynomials with some expensive ones
+    degree[i]   = rand() % 8 == 0 ? 5 + rand() % (maxDegree-4) : 2 + rand() % 3;
+    offset[i+1] = offset[i]+degree[i]+1;
+  }
+  vector<valueType> coeffs(offset[n]);
+  for ( size_t k = 0; k < coeffs.size(); ++k )
+    coeffs[k] = 2*valueType(rand())/RAND_MAX-1;
+
+  indexType nroots = offset[n]-n;
+  vector<valueType> zr1(nroots), zi1(nroots), zr(nroots), zi(nroots);
+  vector<indexType> info1(n), info(n);
+
+  solveBatchParallel(
+    n, &degree.front(), &offset.front(), &coeffs.front(),
+    &zr1.front(), &zi1.front(), &info1.front(), 1
+  );
+
+  vector<ParallelBatchStats> stats(4);
+  indexType nthreads = solveBatchParallel(
+    n, &degree.front(), &offset.front(), &coeffs.front(),
+    &zr.front(), &zi.front(), &info.front(), 4, &stats.front()
+  );
+
+  bool ok = true;
+  for ( indexType i = 0; i < n && ok; ++i ) ok = info[i] == info1[i];
+  for ( indexType k = 0; k < nroots && ok; ++k ) ok = zr[k] == zr1[k] && zi[k] == zi1[k];
+
+  indexType nfail   = 0;
+  indexType nsolved = 0;
+  for ( indexType i = 0; i < n; ++i ) if ( info[i] != 0 ) ++nfail;
+  cout << "threads = " << nthreads << " polynomials = " << n
+       << " failed = " << nfail << '\n';
+  for ( indexType t = 0; t < nthreads; ++t ) {
+    cout << "thread " << t
+         << " solved = " << setw(6) << stats[t].nsolved
+         << " stolen = " << setw(3) << stats[t].nstolen
+         << " time = "   << stats[t].seconds << "s\n";
+    nsolved += stats[t].nsolved;
+  }
+  ok = ok && nsolved == n;
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
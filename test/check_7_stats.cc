@@ -0,0 +1,77 @@
+/*
+.. This program solves polynomials that exercise the different paths of
+.. the solvers and checks the counters of SolverStats of the calling thread
+.. and of all the threads. Without POLYNOMIAL_ROOTS_STATS the counters must
+.. stay zero.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+static
+void
+solveSome() {
+  Cubic   c1( 1, -6, 11, -6 );     // (x-1)*(x-2)*(x-3)
+  Cubic   c2( 1, -3, 2, 0 );       // x*(x-1)*(x-2), special case
+  Cubic   c3( 1, -3, 3, -1 );      // (x-1)^3, triple root
+  Cubic   c4, c5;
+  c4.setupClosedForm( 1, -6, 11, -6 ); // closed form
+  c5.setupClosedForm( 1, -3, 3, -1 );  // fallback to setup, triple root
+  Quartic q1( 1, 0, 5, 0, 4 );     // (x^2+1)*(x^2+4), biquadratic
+  Quartic q2( 1, -10, 35, -50, 24 ); // (x-1)*(x-2)*(x-3)*(x-4)
+  Quartic q3( 1, 0, 3, -6, 10 );   // (x^2+2*x+2)*(x^2-2*x+5), complex roots
+  Quartic q4, q5;
+  q4.setupClosedForm( 1, -10, 35, -50, 24 ); // closed form
+  q5.setupClosedForm( 1, -4, 8, -8, 4 );     // fallback to setup, (x^2-2*x+2)^2
+  // (x-1)*(x-2)*...*(x-6)
+  valueType op[] = { 1, -21, 175, -735, 1624, -1764, 720 };
+  valueType zr[6], zi[6];
+  roots( op, 6, zr, zi );
+  cout << "cubic iter = " << c1.numIter() << " quartic iter = " << q2.numIter() << '\n';
+}
+
+int
+main() {
+  resetStats();
+  solveSome();
+  SolverStats s = getThreadStats();
+
+  thread t( solveSome );
+  t.join();
+  SolverStats g = getGlobalStats();
+
+  bool ok;
+  if ( statsEnabled() ) {
+    s.info( cout );
+    ok = s[SolverStats::CUBIC_SPECIAL]       >= 1 &&
+         s[SolverStats::CUBIC_TRIPLE]        == 2 &&
+         s[SolverStats::CUBIC_CLOSED_FORM]   == 1 &&
+         s[SolverStats::CUBIC_CLOSED_FORM_FALLBACK] == 1 &&
+         s[SolverStats::CUBIC_NEWTON_ITER]   >  0 &&
+         s[SolverStats::QUARTIC_SOLVES]      == 5 &&
+         s[SolverStats::QUARTIC_BIQUADRATIC] == 1 &&
+         s[SolverStats::QUARTIC_REAL_ROOT]   == 1 &&
+         s[SolverStats::QUARTIC_HEXIC] + s[SolverStats::QUARTIC_EQUAL_REAL_PARTS] == 2 &&
+         s[SolverStats::QUARTIC_CLOSED_FORM] == 1 &&
+         s[SolverStats::QUARTIC_CLOSED_FORM_FALLBACK] == 1 &&
+         s[SolverStats::JT_SOLVES]           == 1 &&
+         s[SolverStats::JT_SHIFTS]           >= 1;
+    // the other thread did the same work
+    SolverStats s2 = s;
+    s2 += s;
+    for ( int i = 0; i < SolverStats::numCounters && ok; ++i )
+      ok = g.count[i] == s2.count[i];
+  } else {
+    cout << "statistics not enabled\n";
+    ok = true;
+    for ( int i = 0; i < SolverStats::numCounters && ok; ++i )
+      ok = s.count[i] == 0 && g.count[i] == 0;
+  }
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
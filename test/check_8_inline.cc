@@ -0,0 +1,66 @@
+/*
+.. This program uses the header-only quadratic and cubic solvers of
+.. PolynomialRoots-inline.hh (it does not need the library) and checks
+.. the roots of some polynomials with constant coefficients.
+*/
+
+#include "PolynomialRoots-inline.hh"
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+// evaluation of monic polynomials is usable in constant expressions
+static_assert( evalMonicCubic( 2.0, -6.0, 11.0, -6.0 ) == 0, "evalMonicCubic" );
+static_assert( evalMonicQuartic( 3.0, -10.0, 35.0, -50.0, 24.0 ) == 0, "evalMonicQuartic" );
+
+static
+bool
+check_roots( char const * name, valueType const r[], valueType const exact[], indexType n ) {
+  bool ok = true;
+  for ( indexType i = 0; i < n; ++i )
+    ok = ok && abs(r[i]-exact[i]) <= 1e-14 * (1+abs(exact[i]));
+  cout << name << ( ok ? " OK!" : " FAILED!" ) << '\n';
+  return ok;
+}
+
+int
+main() {
+  bool ok = true;
+  valueType r[3];
+
+  // (x-1)*(x-2)
+  Quadratic q( 1, -3, 2 );
+  valueType const q_exact[] = { 1, 2 };
+  ok = ok && q.getRealRoots( r ) == 2;
+  ok = check_roots( "quadratic", r, q_exact, 2 ) && ok;
+
+  // (x+1)*(x-3)*(x-5)
+  Cubic c( 1, -7, 7, 15 );
+  valueType const c_exact[] = { -1, 3, 5 };
+  ok = ok && c.getRealRoots( r ) == 3;
+  ok = check_roots( "cubic", r, c_exact, 3 ) && ok;
+
+  // (x-1)^3, triple root
+  Cubic t( 1, -3, 3, -1 );
+  valueType const t_exact[] = { 1, 1, 1 };
+  ok = ok && t.tripleRoot() && t.getRealRoots( r ) == 3;
+  ok = check_roots( "triple", r, t_exact, 3 ) && ok;
+
+  // eval and check use evalPoly and evalPolyC, also defined in the header
+  ostringstream null;
+  bool oke = q.eval( valueType(3) ) == 2 && c.eval( valueType(0) ) == 15 &&
+             abs( c.eval( complexType(0,1) ) - complexType(22,6) ) == 0 &&
+             q.check( null ) && c.check( null ) && t.check( null );
+  cout << "eval and check" << ( oke ? " OK!" : " FAILED!" ) << '\n';
+  ok = ok && oke;
+
+  // float instantiation: (x-1)*(x^2+1)
+  CubicT<float> f( 1, -1, 1, -1 );
+  ok = ok && f.complexRoots() && abs(f.real_root2()-1) <= 1e-6f;
+  cout << "float cubic" << ( ok ? " OK!" : " FAILED!" ) << '\n';
+
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/*
+.. This program runs the batch solvers with the kernels compiled for each
+.. SimdLevel supported by the CPU and checks that the results are the same
+.. bit by bit of the generic kernels.
+*/
+
+#include "PolynomialRoots.hh"
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+template <typename Real>
+struct BatchResults {
+  vector<Real>      r, v;
+  vector<indexType> k;
+  vector<char>      f; // vector<bool> is not an array of bool
+
+  bool
+  operator == ( BatchResults const & o ) const
+  { return r == o.r && v == o.v && k == o.k && f == o.f; }
+};
+
+template <typename Real>
+static
+BatchResults<Real>
+runBatch( indexType n, vector<Real> const & cf ) {
+  BatchResults<Real> res;
+  res.r.resize(9*n+40);
+  res.v.resize(3*n);
+  res.k.resize(4*n);
+  res.f.resize(5*n);
+  Real const * A = &cf.front();
+  Real       * r = &res.r.front();
+  indexType  * k = &res.k.front();
+  bool       * f = reinterpret_cast<bool*>(&res.f.front());
+
+  solveQuadraticBatch( n, A, A+n, A+2*n, r, r+n, k, f, f+n );
+  solveCubicBatch( n, A, A+n, A+2*n, A+3*n, r+2*n, r+3*n, r+4*n, k+n, f+2*n, f+3*n, f+4*n );
+  solveQuarticBatch( n, A, A+n, A+2*n, A+3*n, A+4*n, r+5*n, r+6*n, r+7*n, r+8*n, k+2*n, k+3*n );
+
+  // evaluation at points inside and outside the unit disk
+  Real * v = &res.v.front();
+  evalPoly( A, 4, A+5*n, n, v );
+  evalPolyC( A, 4, A+5*n, A+6*n, n, v+n, v+2*n );
+
+  // roots of a polynomial of degree 20 polished on its coefficients
+  roots( A, 20, r+9*n, r+9*n+20 );
+  polishRoots( A, 20, r+9*n, r+9*n+20 );
+  return res;
+}
+
+template <typename Real>
+static
+bool
+do_test( char const * name ) {
+  indexType const n = 1001;
+  vector<Real> cf(7*n);
+  srand(1234);
+  for ( size_t i = 0; i < cf.size(); ++i ) cf[i] = 4*Real(rand())/RAND_MAX-2;
+  // quartics with only complex roots exercise the lanes of solveQuarticBatch
+  for ( indexType i = 0; i < n; i += 3 ) {
+    Real a = cf[i], b = cf[n+i], c = cf[2*n+i], d = cf[3*n+i];
+    Real p = 1+a*a, q = 1+c*c; // (x^2+b*x+p)*(x^2+d*x+q)
+    cf[i] = 1; cf[n+i] = b+d; cf[2*n+i] = p+q+b*d; cf[3*n+i] = b*q+d*p; cf[4*n+i] = p*q;
+  }
+
+  SimdLevel saved = simdLevel();
+  setSimdLevel( SIMD_GENERIC );
+  BatchResults<Real> ref = runBatch<Real>( n, cf );
+  bool ok = true;
+  for ( int l = SIMD_GENERIC+1; l <= simdLevelMax(); ++l ) {
+    SimdLevel lv = setSimdLevel( SimdLevel(l) );
+    bool same = runBatch<Real>( n, cf ) == ref;
+    cout << name << ' ' << simdLevelName( lv ) << ( same ? " OK!" : " FAILED!" ) << '\n';
+    ok = ok && same;
+  }
+  setSimdLevel( saved );
+  return ok;
+}
+
+int
+main() {
+  cout << "active level = " << simdLevelName( simdLevel() )
+       << ", best level = " << simdLevelName( simdLevelMax() ) << '\n';
+  bool ok = simdLevel() == simdLevelMax();
+  ok = do_test<float>( "float" ) && ok;
+  ok = do_test<double>( "double" ) && ok;
+  cout << ( ok ? "All done!" : "Some tests FAILED!" ) << '\n';
+  return ok ? 0 : 1;
+}
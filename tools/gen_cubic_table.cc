@@ -0,0 +1,85 @@
+/*
+.. This program writes PolynomialRoots-CubicTable.hh, the table of the
+.. starting points of the cubic solver used with POLYNOMIAL_ROOTS_CUBIC_TABLE.
+..
+.. For each of the 6 classes of the scaled cubic x^3 + a[2]*x^2 + a[1]*x + a[0]
+.. (one coefficient is +1 or -1, see cubicNewtonSetup) the two free
+.. coefficients span a (N+1)x(N+1) grid on [-1,1]^2. Each node stores the
+.. real root reached by Newton-bisection from guess1..guess6, computed in
+.. long double, so that the table selects the same root as the fits.
+.. It must be compiled without POLYNOMIAL_ROOTS_CUBIC_TABLE.
+..
+.. usage: gen_cubic_table PolynomialRoots-CubicTable.hh
+*/
+
+#include "PolynomialRoots.hh"
+#include "PolynomialRoots-inline.hh"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+using namespace PolynomialRoots;
+
+// number of intervals of the grid in each direction
+static indexType const N = 16;
+
+// coefficients of the cubic of class `iclass` at the free coefficients (u,v)
+static
+void
+classCoeffs( indexType iclass, long double u, long double v, long double a[3] ) {
+  switch ( iclass ) {
+    case 1: a[0] = -1; a[1] = u; a[2] = v; break;
+    case 2: a[0] =  1; a[1] = u; a[2] = v; break;
+    case 3: a[1] = -1; a[0] = u; a[2] = v; break;
+    case 4: a[1] =  1; a[0] = u; a[2] = v; break;
+    case 5: a[2] = -1; a[0] = u; a[1] = v; break;
+    case 6: a[2] =  1; a[0] = u; a[1] = v; break;
+  }
+}
+
+int
+main( int argc, char const * argv[] ) {
+  if ( argc != 2 ) {
+    cerr << "usage: " << argv[0] << " PolynomialRoots-CubicTable.hh\n";
+    return 1;
+  }
+  ofstream file( argv[1] );
+  file << "// generated by tools/gen_cubic_table.cc, do not edit\n\n"
+       << "#ifndef POLYNOMIAL_ROOTS_CUBIC_TABLE_HH\n"
+       << "#define POLYNOMIAL_ROOTS_CUBIC_TABLE_HH\n\n"
+       << "namespace PolynomialRoots {\n\n"
+       << "  //! number of intervals of the grid of `cubicTableData` in each direction\n"
+       << "  static indexType const cubicTableSize = " << N << ";\n\n"
+       << "  //! roots of the scaled cubics of class 1..6 on the grid of the free coefficients\n"
+       << "  inline\n"
+       << "  double const *\n"
+       << "  cubicTableData() {\n"
+       << "    static double const table[] = {\n"
+       << setprecision(17);
+  for ( indexType iclass = 1; iclass <= 6; ++iclass ) {
+    file << "      // class " << iclass << '\n';
+    for ( indexType i = 0; i <= N; ++i ) {
+      file << "     ";
+      for ( indexType j = 0; j <= N; ++j ) {
+        long double a[3];
+        classCoeffs( iclass, -1+2*(long double)(i)/N, -1+2*(long double)(j)/N, a );
+        long double x = cubicClassGuess( iclass, a ); // the fits, this is not compiled with the table
+        NewtonBisection( a[2], a[1], a[0], x );
+        file << ' ' << double(x) << ',';
+      }
+      file << '\n';
+    }
+  }
+  file << "    };\n"
+       << "    return table;\n"
+       << "  }\n\n"
+       << "}\n\n"
+       << "#endif\n";
+  file.close();
+  if ( !file ) {
+    cerr << argv[0] << ": cannot write " << argv[1] << '\n';
+    return 1;
+  }
+  return 0;
+}